@@ -0,0 +1,61 @@
+//! Microbenchmark of the input parser: the time to parse load vector lines
+//! and whole laminate inputs, as run by make bench.
+
+#include <Eigen/Dense>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "../include/ply.h"
+#include "../include/input_parser.h"
+
+using std::cout; using std::endl;
+using std::string; using std::vector;
+
+// Number of lines parsed by each benchmark.
+const int kBenchLines = 500000;
+
+// Seconds elapsed since start.
+double seconds_since(std::chrono::steady_clock::time_point start);
+
+int main() {
+    vector<string> load_lines;
+    for (int i = 0; i < kBenchLines; i++) {
+        load_lines.push_back("Load Vector : [7e6, " + std::to_string(i) 
+                             + ".5, -3.25e3, 12, 0, 1e-3]");
+    }
+    auto start = std::chrono::steady_clock::now();
+    double checksum = 0.;
+    for (string& line : load_lines) {
+        checksum += get_load_vector(line)(1);
+    }
+    double load_seconds = seconds_since(start);
+
+    Properties p;
+    p.E1 = 1.38e11;
+    p.E2 = 1.0e10;
+    p.nu12 = 0.34;
+    p.G12 = 7.0e9;
+    const std::map<string, Properties> materials = {{"M1", p}, {"M2", p}};
+    vector<string> input = {"[0/45/-45/90]2s", "[M1, M2, M1, M2]", 
+                            "[2e-4, 1.5e-4, 2e-4, 1.5e-4]", 
+                            "[7e6, 0, 0, 0, 0, 0]"};
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kBenchLines / 10; i++) {
+        checksum += get_ply_vector(input, materials).size();
+    }
+    double laminate_seconds = seconds_since(start);
+
+    cout << "load vector: " << load_seconds / kBenchLines * 1e9 
+         << " ns per line" << endl;
+    cout << "laminate input: " << laminate_seconds / (kBenchLines / 10) * 1e9 
+         << " ns per input" << endl;
+    cout << "(checksum " << checksum << ")" << endl;
+    return 0;
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+}
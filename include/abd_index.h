@@ -0,0 +1,56 @@
+/**
+ * Prefix-sum index of the A, B, D moments of a laminate. The index stores the
+ * cumulative moments of the plies below every interface about the mid-plane 
+ * of the whole laminate. The stiffness of any contiguous range of plies (e.g.
+ * the plies left after a ply drop, or the plies above a delamination plane) is
+ * the difference of two prefixes, re-referenced to the mid-plane of the range,
+ * which takes constant time.
+ *
+ * The differences lose accuracy for a range that is very thin compared with 
+ * its distance from the laminate mid-plane, where D of the range is small 
+ * compared with the prefixes it is taken from.
+ */
+
+#ifndef ABD_INDEX_H
+#define ABD_INDEX_H
+
+#include <Eigen/Dense>
+#include <cstddef>
+
+#include "layup.h"
+#include "ply_table.h"
+
+struct abd_index {
+    //! Coordinates of the ply interfaces about the laminate mid-plane.
+    Eigen::ArrayXd z_;
+
+    //! Row k holds the unique entries (QbarEntry order) of A, B and D of the
+    //! plies [0, k) about the laminate mid-plane. One more row than plies.
+    Eigen::Matrix<double, Eigen::Dynamic, 6> A_prefix_;
+    Eigen::Matrix<double, Eigen::Dynamic, 6> B_prefix_;
+    Eigen::Matrix<double, Eigen::Dynamic, 6> D_prefix_;
+
+    //! The same prefixes for the shear moments S0, S1 and S2, with the unique
+    //! entries in QsEntry order.
+    Eigen::Matrix<double, Eigen::Dynamic, 3> S0_prefix_;
+    Eigen::Matrix<double, Eigen::Dynamic, 3> S1_prefix_;
+    Eigen::Matrix<double, Eigen::Dynamic, 3> S2_prefix_;
+
+    //! The same prefixes for the thermal and moisture resultants: (N^T, N^H)
+    //! in N_expansion_prefix_ and (M^T, M^H) in M_expansion_prefix_.
+    Eigen::Matrix<double, Eigen::Dynamic, 6> N_expansion_prefix_;
+    Eigen::Matrix<double, Eigen::Dynamic, 6> M_expansion_prefix_;
+
+    //! Build the index from the ply table of the laminate.
+    explicit abd_index(const ply_table& table);
+
+    //! Number of plies.
+    std::size_t size() const;
+
+    //! A, B, D, the shear moments and the expansion resultants of the plies
+    //! [begin, end), about the mid-plane of that range. Requires 
+    //! begin <= end <= size() (asserted).
+    BlockStiffness range(std::size_t begin, std::size_t end) const;
+};
+
+#endif
@@ -0,0 +1,74 @@
+/**
+ * Solver for the laminate stiffness equations 
+ *      [N; M] = [A B; B D] [epsilon; kappa].
+ * The stiffness matrix is symmetric positive definite, so instead of a general
+ * purpose factorization the solver picks a route by the laminate type:
+ *      symmetric laminate (B = 0): the in-plane and bending problems decouple
+ *      into two 3x3 systems, inverted in closed form. If the laminate is also
+ *      balanced (A16 = A26 = 0), A is inverted as a 2x2 block and A66.
+ *      general laminate: fixed-size 6x6 Cholesky (LLT) factorization, with a 
+ *      column-pivoting QR fallback for ill-conditioned matrices.
+ * The result is the compliance matrix [a b; b^T d], so every later load case is
+ * a single 6x6 matrix-vector product, and the effective engineering constants
+ * of the laminate follow from a few of its entries.
+ */
+
+#ifndef ABD_SOLVER_H
+#define ABD_SOLVER_H
+
+#include <Eigen/Dense>
+
+//! The route taken to invert the stiffness matrix.
+enum class SolvePath {
+    decoupled,   // B = 0, two independent 3x3 closed-form inverses.
+    cholesky,    // 6x6 LLT factorization.
+    pivoted_qr   // 6x6 column-pivoting Householder QR (fallback).
+};
+
+//! Compliance submatrices of a laminate, [a b; b^T d] = [A B; B D]^-1, and the
+//! classification of the laminate found while inverting.
+struct ABDCompliance {
+    Eigen::Matrix3d a;
+    Eigen::Matrix3d b;
+    Eigen::Matrix3d d;
+
+    //! B is zero within round-off, e.g. a symmetric laminate.
+    bool is_symmetric;
+
+    //! A16 and A26 are zero within round-off, e.g. a balanced laminate.
+    bool is_balanced;
+
+    SolvePath path;
+};
+
+//! Effective engineering constants of a laminate of height h, from the 
+//! compliance: the in-plane constants from a (Ex = 1/(h a11), ...) and the 
+//! flexural constants from d (Efx = 12/(h^3 d11), ...).
+struct EngineeringConstants {
+    double Ex;
+    double Ey;
+    double Gxy;
+    double nuxy;
+    double nuyx;
+
+    double Efx;
+    double Efy;
+    double Gfxy;
+    double nufxy;
+    double nufyx;
+};
+
+//! Classify the laminate from its A, B, D submatrices and invert the stiffness
+//! matrix by the matching route.
+ABDCompliance invert_abd(const Eigen::Matrix3d& A, const Eigen::Matrix3d& B,
+                         const Eigen::Matrix3d& D);
+
+//! Assemble the 6x6 compliance matrix [a b; b^T d].
+Eigen::Matrix<double, 6, 6> compliance_matrix(const ABDCompliance& compliance);
+
+//! Compute the effective engineering constants of a laminate of the given
+//! height.
+EngineeringConstants engineering_constants(const ABDCompliance& compliance,
+                                           double height);
+
+#endif
@@ -0,0 +1,85 @@
+/**
+ * Streaming batch driver. A batch file holds one self-contained case per
+ * line, with the fields of `laminate_input` separated by semicolons:
+ *      [0/45/-45/90]8s4; [M1, M2, M1, M2]; [2e-4, 1.5e-4, 2e-4, 1.5e-4];
+ *          [7e6, 0, 0, 0, 0, 0]
+ * (on one line), i.e. laminate code; material labels; ply thicknesses; load vector and an
+ * optional [delta_T, delta_C] environment. Blank lines and lines starting
+ * with '#' are skipped.
+ *
+ * Reading, solving and writing run as a pipeline: a reader thread cuts the
+ * file into chunks of lines, worker threads solve the chunks with one
+ * laminate_solver each, and the calling thread writes the results in file
+ * order. At most a fixed window of chunks is in flight, and the plies of the
+ * cases are built without the Qbar cache, so the memory does not grow with
+ * the number of cases or of distinct angles.
+ *
+ * The result file has one row per solved case: the line number of the case,
+ * the mid-plane strains strain_x, strain_y, strain_xy, the curvatures
+ * kappa_x, kappa_y, kappa_xy, and the engineering constants Ex, Ey, Gxy,
+ * nuxy. Invalid cases are reported with their line number and skipped; the
+ * workers keep the messages with the rows of their chunk, so the messages 
+ * are printed in file order.
+ */
+
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+#include <Eigen/Dense>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+#include "ply.h"
+#include "material_db.h"
+
+//! Number of lines of a chunk of the batch file.
+constexpr std::size_t kBatchChunkLines = 256;
+
+//! Number of chunks in flight per worker thread.
+constexpr std::size_t kBatchChunksPerThread = 4;
+
+//! A case of a batch file.
+struct BatchCase {
+    //! Plies from bottom to top.
+    std::vector<BasicLamina<double>> plies;
+
+    //! The in plane forces (Nx, Ny, Nxy) and moments (Mx, My, Mxy).
+    Eigen::Matrix<double, 6, 1> load;
+
+    //! True if the case has the environment field; delta_T and delta_C are 0
+    //! otherwise.
+    bool has_environment;
+    double delta_T;
+    double delta_C;
+};
+
+//! False if the line of a batch file is blank or a comment.
+bool is_batch_record(std::string_view record);
+
+//! Parse a line of a batch file into batch_case. The plies are built directly,
+//! without the Qbar cache. Returns false if the case is invalid.
+bool parse_batch_case(std::string_view record,
+                      const std::map<std::string, Properties>& material_data,
+                      BatchCase& batch_case);
+
+//! Same as above, with the materials of a compiled database: the labels of
+//! the case that material_data does not hold yet are read from the database
+//! and added to it. database is nullptr when material_data already holds
+//! every material (see open_material_data).
+bool parse_batch_case(std::string_view record, const material_db* database,
+                      std::map<std::string, Properties>& material_data,
+                      BatchCase& batch_case);
+
+//! Solve every case of the batch file with the materials of the material
+//! data file (or database), and write the result rows into output_filename.
+//! thread_count 0 uses one worker per hardware thread. Returns the number of
+//! solved cases, or -1 if a file cannot be opened.
+long long run_batch(const std::string& batch_filename,
+                    const std::string& material_data_filename,
+                    const std::string& output_filename,
+                    unsigned thread_count = 0);
+
+#endif
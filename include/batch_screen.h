@@ -0,0 +1,73 @@
+/**
+ * Single-precision batch screening of many candidate laminates. Cases are 
+ * processed kScreenLanes at a time, one case per SIMD lane: the ply 
+ * transforms, the ABD assembly and a 6x6 LDLT solve all run on fixed-size 
+ * float arrays that Eigen vectorizes across the cases.
+ *
+ * The stiffness matrix of each case is equilibrated (scaled to a unit 
+ * diagonal) before the factorization, and the smallest LDLT pivot of the 
+ * scaled matrix is used as an estimate of its conditioning. Cases whose 
+ * estimated float error exceeds the tolerance, or whose result is not finite,
+ * are solved again in double precision with a laminate_solver, which builds
+ * Qbar directly and leaves the Qbar cache alone.
+ *
+ * run_screen screens a file of cases in the batch format of batch_runner.h,
+ * without the environment field, and writes one row per case: the line 
+ * number, the mid-plane strains and curvatures, Ex, Ey, Gxy, nuxy and 1 if
+ * the case was solved again in double precision (0 otherwise).
+ */
+
+#ifndef BATCH_SCREEN_H
+#define BATCH_SCREEN_H
+
+#include <Eigen/Dense>
+#include <vector>
+#include <string>
+#include <cstddef>
+
+#include "clt_core.h"
+#include "abd_solver.h"
+
+//! Number of cases solved together, one per float lane.
+const int kScreenLanes = 8;
+
+//! Number of cases of a file screened at once by run_screen.
+const std::size_t kScreenChunkCases = 4096;
+
+//! A candidate laminate and the load applied to it.
+struct ScreenCase {
+    //! Plies from bottom to top.
+    std::vector<BasicLamina<double>> plies;
+
+    //! The in plane forces (Nx, Ny, Nxy) and moments(Mx, My, Mxy).
+    Eigen::Matrix<double, 6, 1> load;
+};
+
+//! The response of a screened laminate.
+struct ScreenResult {
+    //! Mid-plane strains and curvatures (epsilon_x, epsilon_y, epsilon_xy, 
+    //! kappa_x, kappa_y, kappa_xy).
+    Eigen::Matrix<double, 6, 1> response;
+
+    //! Effective engineering constants, from the compliance of the same 
+    //! precision as the response.
+    EngineeringConstants constants;
+
+    //! True if the case was flagged and solved again in double precision.
+    bool refined;
+};
+
+//! Solve all cases in single precision and re-run the flagged ones in double
+//! precision. tolerance is the accepted relative error of the float solution.
+std::vector<ScreenResult> screen_laminates(const std::vector<ScreenCase>& cases,
+                                           double tolerance = 1e-3);
+
+//! Screen every case of the file with the materials of the material data 
+//! file (or database) and write the result rows into output_filename. Returns
+//! the number of screened cases, or -1 if a file cannot be opened.
+long long run_screen(const std::string& cases_filename,
+                     const std::string& material_data_filename,
+                     const std::string& output_filename,
+                     double tolerance = 1e-3);
+
+#endif
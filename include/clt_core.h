@@ -0,0 +1,416 @@
+/**
+ * The classical laminate theory core, templated on the scalar type. The same
+ * code runs in float for wide batch sweeps, in double for the regular 
+ * calculation (ply, laminate and the rest of the program instantiate it with
+ * double), in long double for reference checks, and with 
+ * Eigen::AutoDiffScalar (unsupported/Eigen/AutoDiff) for derivatives with
+ * respect to material properties, angles or thicknesses.
+ *
+ * Everything here is a template defined in the header, so the double path 
+ * compiles to the same code as a hand-written double implementation.
+ */
+
+#ifndef CLT_CORE_H
+#define CLT_CORE_H
+
+#include <Eigen/Dense>
+#include <cmath>
+#include <vector>
+#include <limits>
+#include <type_traits>
+
+//! Material properties of a composite ply.
+template <typename Scalar>
+struct BasicProperties {
+    
+    //! Young's modulus in the first principle direction.
+    Scalar E1;
+
+    //! Young's modulus in the second principle direction.
+    Scalar E2;
+
+    //! Poisson's ration in the 12 direction.
+    Scalar nu12;
+
+    //! Shear modulus in the 12 direction.
+    Scalar G12;
+
+    //! Transverse shear moduli in the 13 and 23 directions. Only needed for
+    //! the transverse shear stiffness; zero when the material data does not
+    //! give them.
+    Scalar G13 = Scalar(0);
+    Scalar G23 = Scalar(0);
+
+    //! Coefficients of thermal expansion in the 1 and 2 directions.
+    Scalar alpha1 = Scalar(0);
+    Scalar alpha2 = Scalar(0);
+
+    //! Coefficients of moisture swelling in the 1 and 2 directions.
+    Scalar beta1 = Scalar(0);
+    Scalar beta2 = Scalar(0);
+
+};
+
+//! Material invariants of the in-plane stiffness (Tsai-Pagano). With them the
+//! transformed stiffness of any orientation needs only cos2θ, sin2θ, cos4θ 
+//! and sin4θ:
+//!     Q11 = U1 + U2 cos2θ + U3 cos4θ     Q16 = U2/2 sin2θ + U3 sin4θ
+//!     Q22 = U1 - U2 cos2θ + U3 cos4θ     Q26 = U2/2 sin2θ - U3 sin4θ
+//!     Q12 = U4 - U3 cos4θ                Q66 = U5 - U3 cos4θ
+template <typename Scalar>
+struct BasicInvariants {
+    Scalar U1;
+    Scalar U2;
+    Scalar U3;
+    Scalar U4;
+    Scalar U5;
+};
+
+//! The stiffness contribution of a contiguous block of plies. A, B and D are
+//! measured about the mid-plane of the block itself, so that blocks can be 
+//! stacked, mirrored and repeated without knowing their final position.
+template <typename Scalar>
+struct BasicBlockStiffness {
+    Eigen::Matrix<Scalar, 3, 3> A;
+    Eigen::Matrix<Scalar, 3, 3> B;
+    Eigen::Matrix<Scalar, 3, 3> D;
+
+    //! Zeroth, first and second moments through the block of the transverse
+    //! shear stiffness Qs, the shear counterparts of A, B and D. They combine
+    //! like A, B and D, and give the shear-corrected stiffness of a whole
+    //! laminate (see transverse_shear_stiffness).
+    Eigen::Matrix<Scalar, 2, 2> S0;
+    Eigen::Matrix<Scalar, 2, 2> S1;
+    Eigen::Matrix<Scalar, 2, 2> S2;
+
+    //! Thermal force and moment resultants (N^T, M^T) per unit temperature 
+    //! change, the zeroth and first moments of Qbar alpha through the block.
+    Eigen::Matrix<Scalar, 3, 1> NT;
+    Eigen::Matrix<Scalar, 3, 1> MT;
+
+    //! Moisture force and moment resultants (N^H, M^H) per unit moisture 
+    //! change, the moments of Qbar beta.
+    Eigen::Matrix<Scalar, 3, 1> NH;
+    Eigen::Matrix<Scalar, 3, 1> MH;
+
+    //! Total thickness of the block.
+    Scalar height;
+};
+
+//! A single ply given by value, for evaluating a laminate with the core alone.
+template <typename Scalar>
+struct BasicLamina {
+    BasicProperties<Scalar> properties;
+
+    //! Fiber orientation in degrees.
+    Scalar theta;
+
+    Scalar thickness;
+};
+
+//! The trigonometric coefficients (cos2θ, sin2θ, cos4θ, sin4θ) of a ply 
+//! angle used with the invariants.
+template <typename Scalar>
+struct BasicAngleCoefficients {
+    Scalar c2;
+    Scalar s2;
+    Scalar c4;
+    Scalar s4;
+};
+using AngleCoefficients = BasicAngleCoefficients<double>;
+
+//! sqrt(3)/2, rounded once to the nearest Scalar.
+template <typename Scalar> 
+constexpr Scalar kHalfSqrt3 = 0.86602540378443864676372317075293618347L;
+template <> 
+constexpr double kHalfSqrt3<double> = 0.86602540378443864676372317075293618347;
+template <> 
+constexpr float kHalfSqrt3<float> = 0.86602540378443864676372317075293618347f;
+
+//! Exact coefficients of the standard orientations, known at compile time, in
+//! the precision of Scalar. Using them instead of sin/cos keeps the coupling 
+//! terms (e.g. Q16 and Q26 of 0 and 90 degree plies) exactly zero. Only the 
+//! angles below are defined.
+template <int Degrees, typename Scalar = double> struct standard_angle;
+template <typename Scalar> struct standard_angle<0, Scalar> {
+    static constexpr BasicAngleCoefficients<Scalar> value{1, 0, 1, 0};
+};
+template <typename Scalar> struct standard_angle<30, Scalar> {
+    static constexpr BasicAngleCoefficients<Scalar> value{
+        0.5, kHalfSqrt3<Scalar>, -0.5, kHalfSqrt3<Scalar>};
+};
+template <typename Scalar> struct standard_angle<-30, Scalar> {
+    static constexpr BasicAngleCoefficients<Scalar> value{
+        0.5, -kHalfSqrt3<Scalar>, -0.5, -kHalfSqrt3<Scalar>};
+};
+template <typename Scalar> struct standard_angle<45, Scalar> {
+    static constexpr BasicAngleCoefficients<Scalar> value{0, 1, -1, 0};
+};
+template <typename Scalar> struct standard_angle<-45, Scalar> {
+    static constexpr BasicAngleCoefficients<Scalar> value{0, -1, -1, 0};
+};
+template <typename Scalar> struct standard_angle<60, Scalar> {
+    static constexpr BasicAngleCoefficients<Scalar> value{
+        -0.5, kHalfSqrt3<Scalar>, -0.5, -kHalfSqrt3<Scalar>};
+};
+template <typename Scalar> struct standard_angle<-60, Scalar> {
+    static constexpr BasicAngleCoefficients<Scalar> value{
+        -0.5, -kHalfSqrt3<Scalar>, -0.5, kHalfSqrt3<Scalar>};
+};
+template <typename Scalar> struct standard_angle<90, Scalar> {
+    static constexpr BasicAngleCoefficients<Scalar> value{-1, 0, 1, 0};
+};
+
+//! Find the exact coefficients if theta (in degrees) is a standard orientation,
+//! including its equivalents 180 degrees apart (e.g. 135 = -45). Returns false
+//! for any other angle, including an infinite or NaN theta. Scalar is a 
+//! floating point type; the angle is compared in its own precision.
+template <typename Scalar>
+constexpr bool lookup_standard_angle(Scalar theta, 
+                                     BasicAngleCoefficients<Scalar>& result) {
+    // std::isfinite is not constexpr.
+    constexpr Scalar kMaxAngle = std::numeric_limits<Scalar>::max();
+    if (theta != theta || theta > kMaxAngle || theta < -kMaxAngle) {
+        return false;
+    }
+    // Bring theta into [-90, 90]. std::remainder is exact for any angle but 
+    // not constexpr (std::is_constant_evaluated is C++20, hence the builtin),
+    // so the loops only run in constant evaluation.
+    if (__builtin_is_constant_evaluated()) {
+        while (theta > 90) {
+            theta -= 180;
+        }
+        while (theta < -90) {
+            theta += 180;
+        }
+    } else {
+        theta = std::remainder(theta, Scalar(180));
+    }
+    if (theta == 0) {
+        result = standard_angle<0, Scalar>::value;
+    } else if (theta == 30) {
+        result = standard_angle<30, Scalar>::value;
+    } else if (theta == -30) {
+        result = standard_angle<-30, Scalar>::value;
+    } else if (theta == 45) {
+        result = standard_angle<45, Scalar>::value;
+    } else if (theta == -45) {
+        result = standard_angle<-45, Scalar>::value;
+    } else if (theta == 60) {
+        result = standard_angle<60, Scalar>::value;
+    } else if (theta == -60) {
+        result = standard_angle<-60, Scalar>::value;
+    } else if (theta == 90 || theta == -90) {
+        result = standard_angle<90, Scalar>::value;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+//! Contruct the stiffness matrix of the ply in the ply coordinates.
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 3> build_Q(const BasicProperties<Scalar>& p) {
+    Scalar D = 1 - p.E2 / p.E1 * (p.nu12 * p.nu12);
+    Eigen::Matrix<Scalar, 3, 3> Q;
+
+    Q << p.E1/D       , p.nu12*p.E2/D, Scalar(0),
+         p.nu12*p.E2/D, p.E2/D       , Scalar(0),
+         Scalar(0)    , Scalar(0)    , p.G12;
+
+    return Q;
+}
+
+//! Compute the material invariants from the material properties.
+template <typename Scalar>
+BasicInvariants<Scalar> build_invariants(const BasicProperties<Scalar>& p) {
+    Eigen::Matrix<Scalar, 3, 3> Q = build_Q(p);
+    Scalar Q11 = Q(0, 0);
+    Scalar Q22 = Q(1, 1);
+    Scalar Q12 = Q(0, 1);
+    Scalar Q66 = Q(2, 2);
+    BasicInvariants<Scalar> u;
+    u.U1 = (3*Q11 + 3*Q22 + 2*Q12 + 4*Q66) / 8;
+    u.U2 = (Q11 - Q22) / 2;
+    u.U3 = (Q11 + Q22 - 2*Q12 - 4*Q66) / 8;
+    u.U4 = (Q11 + Q22 + 6*Q12 - 4*Q66) / 8;
+    u.U5 = (Q11 + Q22 - 2*Q12 + 4*Q66) / 8;
+    return u;
+}
+
+//! Transform the stiffness with the invariants, given cos2θ, sin2θ, cos4θ and
+//! sin4θ of the ply angle.
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 3> qbar_from_invariants(
+    const BasicInvariants<Scalar>& u, const Scalar& c2, const Scalar& s2, 
+    const Scalar& c4, const Scalar& s4) {
+    Scalar Q11 = u.U1 + u.U2*c2 + u.U3*c4;
+    Scalar Q22 = u.U1 - u.U2*c2 + u.U3*c4;
+    Scalar Q12 = u.U4 - u.U3*c4;
+    Scalar Q66 = u.U5 - u.U3*c4;
+    Scalar Q16 = u.U2/2*s2 + u.U3*s4;
+    Scalar Q26 = u.U2/2*s2 - u.U3*s4;
+    Eigen::Matrix<Scalar, 3, 3> Qbar;
+    Qbar << Q11, Q12, Q16,
+            Q12, Q22, Q26,
+            Q16, Q26, Q66;
+    return Qbar;
+}
+
+//! Compute the stiffness matrix in the laminate coordinates from the material
+//! invariants and the ply angle theta (in degrees). For floating point 
+//! scalars, standard orientations use the exact coefficients of 
+//! standard_angle and other angles use sin and cos. Other scalars (e.g. 
+//! AutoDiff) always use sin and cos, so that derivatives in theta are kept.
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 3> build_Qbar(
+    const BasicInvariants<Scalar>& invariants, const Scalar& theta) {
+    if constexpr (std::is_floating_point<Scalar>::value) {
+        BasicAngleCoefficients<Scalar> exact = {0, 0, 0, 0};
+        if (lookup_standard_angle(theta, exact)) {
+            return qbar_from_invariants<Scalar>(invariants, 
+                exact.c2, exact.s2, exact.c4, exact.s4);
+        }
+    }
+
+    using std::cos; using std::sin;
+    const Scalar pi = 
+        static_cast<Scalar>(3.14159265358979323846264338327950288L);
+    Scalar angle_radian = theta * pi/180;
+    Scalar c2 = cos(2 * angle_radian);
+    Scalar s2 = sin(2 * angle_radian);
+    
+    // Transformation from ply coordinates to laminate coordinates.
+    return qbar_from_invariants<Scalar>(invariants, c2, s2, 
+                                        c2*c2 - s2*s2, 2*s2*c2);
+}
+
+//! Compute cos2θ and sin2θ of the ply angle theta (in degrees), exactly for 
+//! the standard orientations when Scalar is a floating point type.
+template <typename Scalar>
+void double_angle_terms(const Scalar& theta, Scalar& c2, Scalar& s2) {
+    bool exact_angle = false;
+    if constexpr (std::is_floating_point<Scalar>::value) {
+        BasicAngleCoefficients<Scalar> exact = {0, 0, 0, 0};
+        exact_angle = lookup_standard_angle(theta, exact);
+        if (exact_angle) {
+            c2 = exact.c2;
+            s2 = exact.s2;
+        }
+    }
+    if (!exact_angle) {
+        using std::cos; using std::sin;
+        const Scalar pi = 
+            static_cast<Scalar>(3.14159265358979323846264338327950288L);
+        c2 = cos(2 * theta * pi/180);
+        s2 = sin(2 * theta * pi/180);
+    }
+}
+
+//! Compute the transverse shear stiffness [Q44 Q45; Q45 Q55] in the laminate 
+//! coordinates (yz, xz) from G13, G23 and the ply angle theta (in degrees).
+template <typename Scalar>
+Eigen::Matrix<Scalar, 2, 2> build_Qs(const BasicProperties<Scalar>& p, 
+                                     const Scalar& theta) {
+    Scalar c2, s2;
+    double_angle_terms(theta, c2, s2);
+    // cos^2 = (1 + cos2θ)/2, sin^2 = (1 - cos2θ)/2, sin cos = sin2θ/2.
+    Scalar mean = (p.G13 + p.G23) / 2;
+    Scalar half_difference = (p.G13 - p.G23) / 2;
+    Eigen::Matrix<Scalar, 2, 2> Qs;
+    Qs << mean - half_difference*c2, half_difference*s2,
+          half_difference*s2       , mean + half_difference*c2;
+    return Qs;
+}
+
+//! Transform the expansion coefficients (e1, e2) of a ply along its 
+//! principal directions, e.g. (alpha1, alpha2), into the laminate 
+//! coordinates (e_x, e_y, e_xy), with e_xy an engineering shear strain.
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 1> transform_expansion(const Scalar& e1, 
+    const Scalar& e2, const Scalar& theta) {
+    Scalar c2, s2;
+    double_angle_terms(theta, c2, s2);
+    Scalar mean = (e1 + e2) / 2;
+    Scalar half_difference = (e1 - e2) / 2;
+    Eigen::Matrix<Scalar, 3, 1> expansion;
+    expansion << mean + half_difference*c2, 
+                 mean - half_difference*c2, 
+                 2*half_difference*s2;
+    return expansion;
+}
+
+//! Shear-corrected transverse shear stiffness [A44 A45; A45 A55] of a 
+//! laminate (Whitney): 
+//!     As = 5/4 sum Qs (z_k - z_k-1 - 4/(3h^2) (z_k^3 - z_k-1^3)) 
+//!        = 5/4 (S0 - 4/h^2 S2),
+//! with S0, S2 of the whole laminate about its mid-plane.
+template <typename Scalar>
+Eigen::Matrix<Scalar, 2, 2> transverse_shear_stiffness(
+    const Eigen::Matrix<Scalar, 2, 2>& S0, 
+    const Eigen::Matrix<Scalar, 2, 2>& S2, const Scalar& height) {
+    return Scalar(5)/4 * (S0 - Scalar(4) / (height * height) * S2);
+}
+
+//! Assemble the A, B, D submatrices, the shear moments and the thermal and
+//! moisture resultants of plies ordered from bottom to top, about their 
+//! mid-plane.
+template <typename Scalar>
+BasicBlockStiffness<Scalar> assemble_abd(
+    const std::vector<BasicLamina<Scalar>>& plies) {
+    BasicBlockStiffness<Scalar> block;
+    block.height = Scalar(0);
+    for (const auto& p : plies) {
+        block.height += p.thickness;
+    }
+    block.A.setZero();
+    block.B.setZero();
+    block.D.setZero();
+    block.S0.setZero();
+    block.S1.setZero();
+    block.S2.setZero();
+    block.NT.setZero();
+    block.MT.setZero();
+    block.NH.setZero();
+    block.MH.setZero();
+    Scalar bottom = -block.height/2;
+    for (const auto& p : plies) {
+        Scalar top = bottom + p.thickness;
+        Eigen::Matrix<Scalar, 3, 3> Qbar = 
+            build_Qbar(build_invariants(p.properties), p.theta);
+        Eigen::Matrix<Scalar, 2, 2> Qs = build_Qs(p.properties, p.theta);
+        Eigen::Matrix<Scalar, 3, 1> Q_alpha = Qbar * transform_expansion(
+            p.properties.alpha1, p.properties.alpha2, p.theta);
+        Eigen::Matrix<Scalar, 3, 1> Q_beta = Qbar * transform_expansion(
+            p.properties.beta1, p.properties.beta2, p.theta);
+        Scalar w0 = p.thickness;
+        Scalar w1 = p.thickness * (top + bottom) / 2;
+        Scalar w2 = p.thickness * (top*top + top*bottom + bottom*bottom) / 3;
+        block.A += Qbar * w0;
+        block.B += Qbar * w1;
+        block.D += Qbar * w2;
+        block.S0 += Qs * w0;
+        block.S1 += Qs * w1;
+        block.S2 += Qs * w2;
+        block.NT += Q_alpha * w0;
+        block.MT += Q_alpha * w1;
+        block.NH += Q_beta * w0;
+        block.MH += Q_beta * w1;
+        bottom = top;
+    }
+    return block;
+}
+
+//! Solve the mid-plane strains and curvatures (epsilon_x, epsilon_y, 
+//! epsilon_xy, kappa_x, kappa_y, kappa_xy) for the load (Nx, Ny, Nxy, Mx, My,
+//! Mxy) with a 6x6 LDLT factorization.
+template <typename Scalar>
+Eigen::Matrix<Scalar, 6, 1> solve_abd(const BasicBlockStiffness<Scalar>& abd,
+                                      const Eigen::Matrix<Scalar, 6, 1>& load) {
+    Eigen::Matrix<Scalar, 6, 6> stiffness;
+    stiffness << abd.A, abd.B,
+                 abd.B, abd.D;
+    return stiffness.ldlt().solve(load);
+}
+
+#endif
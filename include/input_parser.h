@@ -4,12 +4,15 @@
  * 
  * `laminate_input`: The parser will only read lines with enclosing square 
  * brackets, and all information before "[" (but not "]") will be ignored.
- * The file should contain 4 lines in the given sequence--
+ * The file should contain 4 lines in the given sequence, and an optional 5th
+ * line--
  *      Laminate Code: The standard notation describe the stack sequence 
  *      of a composite laminate per Classical Laminate Theory (CLT), 
  *      e.g. `[0/45/-45/90]2s2`. The string after the right bracket served as 
  *      the subscript of the notation. The forward slash delimiter "/" can be 
- *      replaced by a space " " or a comma ",".
+ *      replaced by a space " " or a comma ",". Groups, repeats, pairs and a
+ *      barred mid-plane ply of the extended grammar (see laminate_code.h) are
+ *      also read, e.g. `[(0/90)2/±45]s`.
  *      
  *      Material Label: The material name that will be used for each ply in the
  *      composite laminate, corresponds to the element inside the square 
@@ -26,24 +29,45 @@
  *      as [Nx, Ny, Nxy, Mx, My, My]. Nx, Ny, Nxy denote in-plane forces of 
  *      the laminate, M denote moments apply to the laminate.
  * 
- * `material_data`: First line of the file will be ignored (served as the 
- * column labels). The remaining line should be datas for each materials.
- * each line should have the following properties in the given sequence, 
- * separated by spaces: 
- *      material label (material name)
+ *      Environment (optional): The temperature change and the moisture change
+ *      applied to the laminate, as [delta_T, delta_C]. Both are 0 if the line
+ *      is not given.
+ * 
+ * `material_data`: First line of the file holds the column labels. The 
+ * remaining line should be datas for each materials, with the material label
+ * (material name) first and then one value per column label, separated by 
+ * spaces. The columns after the label may come in any order: 
  *      E1 (Young's modulus in the first principle direction)
  *      E2 (Young's modulus in the second principle direction)
  *      nu12 (Poisson's ratio in the 12 direction)
  *      G12 (Shear modulus in the 12 direction)
+ *      G13, G23 (optional, transverse shear moduli, 0 if not given)
+ *      alpha1, alpha2 (optional, coefficients of thermal expansion)
+ *      beta1, beta2 (optional, coefficients of moisture swelling)
+ * The `material_data` file may also be a binary material database compiled 
+ * with compile_material_data, which is recognized by its magic number. Only
+ * the records of the labels in use are then read.
+ *
+ * `load_cases` (optional): Every line with enclosing square brackets is read
+ * as one load vector with the same format as the Load Vector line above, e.g.
+ *      Case 1 : [7e6, 0, 0, 0, 0, 0]
+ *      Case 2 : [0, 0, 0, 50, 0, 0]
+ * All load cases are solved against a single factorization of the laminate
+ * stiffness matrix.
  */
 
 
 #ifndef INPUT_PARSER_H
 #define INPUT_PARSER_H
 
+#include <map>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 #include "ply.h"
+#include "layup.h"
+#include "material_db.h"
 
 //! Read the laminate_input file, strip lines without matching square brackets 
 //! and strings before left bracket, and return a vector containing each line
@@ -57,8 +81,69 @@ std::vector<ply> get_ply_vector(
     std::vector<std::string>& laminate_strings,
     const std::string& material_data_filename);
 
-//! Read the load vector string and returns the Eigen::vector object.
-Eigen::Matrix<double, 6, 1> get_load_vector(std::string& load_vector_string);
+//! Same as above, with the materials already read by get_material_data, e.g.
+//! to build many laminates from one material file. Returns an empty vector,
+//! after printing the reason, if a label is unknown or the code, the labels
+//! and the thicknesses do not match.
+std::vector<ply> get_ply_vector(
+    std::vector<std::string>& laminate_strings,
+    const std::map<std::string, Properties>& material_data);
+
+//! Same as above, but each ply is returned only as its properties, angle and
+//! thickness. No ply object is built, so the Qbar cache is not used, e.g. for
+//! solvers that compute Qbar themselves (laminate_solver, batch_screen).
+std::vector<BasicLamina<double>> get_lamina_vector(
+    std::vector<std::string>& laminate_strings,
+    const std::map<std::string, Properties>& material_data);
+
+//! Open the materials of a material_data file or of a compiled material 
+//! database for many cases. A text file is read into material_data at once 
+//! and nullptr is returned. A database is returned open, with material_data
+//! left empty, so that find_materials reads only the labels in use. nullptr
+//! is also returned for a database that cannot be opened.
+std::unique_ptr<material_db> open_material_data(const std::string& filename,
+    std::map<std::string, Properties>& material_data);
+
+//! Add to material_data the labels it does not hold yet, read from the 
+//! database, so each distinct label is looked up once. Labels that are not in
+//! the database are left out.
+void find_materials(const material_db& database, 
+                    const std::vector<std::string>& labels,
+                    std::map<std::string, Properties>& material_data);
+
+//! Read the material labels inside the brackets of a line.
+std::vector<std::string> bracket_labels(std::string_view line);
+
+//! Read the laminate code string and the material_data, and return the 
+//! compressed layup of the laminate, which keeps only the plies inside the 
+//! brackets of the laminate code and the subscript. The plies of an extended
+//! code are kept expanded. The layup has no plies, after the reason is
+//! printed, if the input is invalid.
+layup get_layup(
+    std::vector<std::string>& laminate_strings,
+    const std::string& material_data_filename);
+
+//! Read the load vector string and returns the Eigen::vector object. 
+//! Available for float, double (the default) and long double.
+template <typename Scalar = double>
+Eigen::Matrix<Scalar, 6, 1> get_load_vector(std::string& load_vector_string);
+
+//! Read the environment string [delta_T, delta_C] and return 
+//! (delta_T, delta_C).
+Eigen::Vector2d get_environment(std::string& environment_string);
+
+//! Read the load_cases file and return a 6xN matrix, each column of which is
+//! the load vector of one load case. Returns an empty matrix if the file
+//! cannot be read.
+Eigen::Matrix<double, 6, Eigen::Dynamic> get_load_cases(
+    const std::string& filename);
+
+//! Compile the text material_data file into a binary material database (see
+//! material_db.h). Returns false, without writing the database, if the file
+//! cannot be read, has an invalid header or a corrupted line, and false if
+//! the database cannot be written.
+bool compile_material_data(const std::string& material_data_filename,
+                           const std::string& database_filename);
 
 //! Get minimum thickness of all plys. Used for calculating sampling point
 //! spacing of the laminate.
@@ -4,15 +4,37 @@
  * laminate subject to the external loads. 
  */
 
-
+#ifndef LAMINATE_H
+#define LAMINATE_H
 
 #include <Eigen/Dense>
 #include <vector>
 #include <array>
 #include <string>
 #include <cmath>
+#include <cstddef>
 
 #include "ply.h"
+#include "abd_solver.h"
+#include "abd_index.h"
+#include "layup.h"
+
+//! The exact stress and strain profile through one ply. Strain is linear in z
+//! through the whole laminate and stress is linear within each ply, so the 
+//! values at the bottom and the top of the ply describe the profile exactly.
+struct PlySegment {
+    //! Coordinates of the bottom and the top surface of the ply.
+    double bottom_pt;
+    double top_pt;
+
+    //! Strains (epsilon_x, epsilon_y, epsilon_xy) at the bottom and the top.
+    Eigen::Vector3d bottom_strain;
+    Eigen::Vector3d top_strain;
+
+    //! Stresses (sigma_x, sigma_y, sigma_xy) at the bottom and the top.
+    Eigen::Vector3d bottom_stress;
+    Eigen::Vector3d top_stress;
+};
 
 struct laminate {
         //! A vector containing ply struct from bottom to top.
@@ -25,6 +47,24 @@ struct laminate {
         Eigen::Matrix3d A_;
         Eigen::Matrix3d B_;
         Eigen::Matrix3d D_;
+
+        // S0_, S1_, S2_ are the moments of the transverse shear stiffness of
+        // the plies about the mid-plane (see BasicBlockStiffness).
+        Eigen::Matrix2d S0_;
+        Eigen::Matrix2d S1_;
+        Eigen::Matrix2d S2_;
+
+        //! Shear-corrected transverse shear stiffness [A44 A45; A45 A55] for
+        //! first-order shear deformation theory.
+        Eigen::Matrix2d As_;
+
+        //! Thermal force and moment resultants (N^T, M^T) per unit 
+        //! temperature change, and moisture resultants (N^H, M^H) per unit 
+        //! moisture change, accumulated with A_, B_, D_.
+        Eigen::Vector3d NT_;
+        Eigen::Vector3d MT_;
+        Eigen::Vector3d NH_;
+        Eigen::Vector3d MH_;
         
         //! Engineering strains(epsilon_x, epsilon_y, epsilon_xy) at the 
         //! mid-plane of the laminate
@@ -34,8 +74,23 @@ struct laminate {
         //! of the laminate.
         Eigen::Vector3d mid_curvature_;
 
+        //! The exact profile of the laminate, one segment per ply from bottom
+        //! to top. A ply edit only marks it stale; read it through 
+        //! profile_segments(), which recomputes it first.
+        mutable std::vector<PlySegment> profile_segments_;
+        mutable bool profile_segments_stale_;
+
+        //! Stiffness of the plies for the ply edits, as a tree in heap order:
+        //! node 1 is the whole laminate, the children of node k are 2k and 
+        //! 2k+1, and ply i is leaf block_tree_.size()/2 + i. Each node holds
+        //! its plies about their own mid-plane (see stack_blocks). The tree is
+        //! built by the first edit, and an edit recombines only the nodes 
+        //! above the edited ply.
+        std::vector<BlockStiffness> block_tree_;
+
         //! Stresses (sigma_x, sigma_y, sigma_xy) at each sampling point of the
         //! laminate. First element of the vector corresponds to the bottom point.
+        //! The sampling vectors are only filled by sample_profile.
         std::vector<Eigen::Vector3d> stresses_;
 
         //! Strains (epsilon_x, epsilon_y, epsilon_xy) at each sampling point 
@@ -49,9 +104,103 @@ struct laminate {
         //! The in plane forces (Nx, Ny, Nxy) and moments(Mx, My, Mxy) 
         //! applied to the laminate.
         Eigen::Matrix<double, 6, 1> load_vector_;
+
+        //! Temperature change and moisture change applied to the laminate.
+        double delta_T_;
+        double delta_C_;
+
+        //! Compliance submatrices [a b; b^T d] = [A B; B D]^-1, and the route 
+        //! taken to compute them. It is computed once in the constructor and
+        //! reused for every load case.
+        ABDCompliance compliance_;
+
+        //! Effective in-plane and flexural engineering constants, updated 
+        //! together with the compliance.
+        EngineeringConstants engineering_constants_;
         
         //! The laminate contructor. ply_vector and load_vector comes from material
-        //! data. pt_spacing is the distance between sampling point of the laminate.
+        //! data. The temperature and moisture changes are folded into the 
+        //! solve as equivalent loads (see environmental_load). If a ply is 
+        //! not thicker than 0, the error is printed and the laminate is empty.
         laminate(std::vector<ply>& ply_vector, 
-                Eigen::Matrix<double, 6, 1>& load_vector, double pt_spacing);
-};
\ No newline at end of file
+                Eigen::Matrix<double, 6, 1>& load_vector,
+                double delta_T = 0., double delta_C = 0.);
+
+        //! Construct the laminate of a compressed layup. A_, B_, D_ and the
+        //! other moments are composed from its base sequence in closed form
+        //! (see layup::stiffness); the plies are expanded only for the 
+        //! per-ply profile.
+        laminate(const layup& plies, 
+                Eigen::Matrix<double, 6, 1>& load_vector,
+                double delta_T = 0., double delta_C = 0.);
+
+        //! The forces and moments equivalent to delta_T_ and delta_C_:
+        //! (delta_T N^T + delta_C N^H, delta_T M^T + delta_C M^H).
+        Eigen::Matrix<double, 6, 1> environmental_load() const;
+
+        //! The profile segments, recomputed if a ply was edited since they
+        //! were last computed. Call it once before reading the laminate from
+        //! several threads; profile_view does.
+        const std::vector<PlySegment>& profile_segments() const;
+
+        //! Free thermal and moisture strain of the i-th ply. The stresses of
+        //! the ply come from the strain in excess of it.
+        Eigen::Vector3d free_strain(std::size_t i) const;
+
+        //! Sample the profile at equally spaced points, pt_spacing apart, 
+        //! from the bottom to the top of the laminate, and store the samples
+        //! into stresses_, strains_ and profile_pt_. Consumers that only need
+        //! to read the samples once should iterate a profile_view instead.
+        //! The samples are split into contiguous ranges filled by 
+        //! thread_count threads; a thread_count of 0 uses one thread for 
+        //! small profiles and all hardware threads for large ones.
+        void sample_profile(double pt_spacing, unsigned thread_count = 0);
+
+        //! Solve the mid-plane strains and curvatures for each column of
+        //! mechanical load_cases with the cached compliance. Add 
+        //! environmental_load() to a column for the environment of the 
+        //! laminate. Each column of the result
+        //! is (epsilon_x, epsilon_y, epsilon_xy, kappa_x, kappa_y, kappa_xy)
+        //! of the corresponding load case.
+        Eigen::Matrix<double, 6, Eigen::Dynamic> solve_load_cases(
+            const Eigen::Matrix<double, 6, Eigen::Dynamic>& load_cases) const;
+
+        //! Build the unit-load basis of the ply stresses. The response is 
+        //! linear in the load, so the stresses (sigma_x, sigma_y, sigma_xy) at
+        //! the bottom and top of every ply are the rows of this matrix times 
+        //! the load vector. Rows 6k to 6k+2 correspond to the bottom of the 
+        //! k-th ply and rows 6k+3 to 6k+5 to its top. Multiplying the basis 
+        //! by a 6xN matrix of load cases gives the ply stresses of all cases
+        //! in a single matrix product. Under a temperature or moisture 
+        //! change, multiply the basis by the loads plus environmental_load()
+        //! and add restrained_free_stress().
+        Eigen::Matrix<double, Eigen::Dynamic, 6> stress_basis() const;
+
+        //! The stresses -Qbar free_strain(k) of each ply k, in the row order of
+        //! stress_basis.
+        Eigen::Matrix<double, Eigen::Dynamic, 1> restrained_free_stress() const;
+
+        //! Build the prefix-sum index of the ABD moments, from which the 
+        //! stiffness of any contiguous range of plies is found in constant 
+        //! time.
+        abd_index build_abd_index() const;
+
+        //! Change the fiber orientation of the i-th ply (counting from the 
+        //! bottom). A_, B_, D_ are recombined from block_tree_ in 
+        //! O(log(ply count)), then the response is solved again for 
+        //! load_vector_.
+        void set_ply_angle(std::size_t i, double theta);
+
+        //! Change the material of the i-th ply, updating the laminate in the
+        //! same way as set_ply_angle.
+        void set_ply_material(std::size_t i, const std::string& material_label,
+                              const Properties& material_properties);
+
+        //! Change the thickness of the i-th ply, updating the laminate in the
+        //! same way as set_ply_angle. The plies above it move up, and the 
+        //! mid-plane moves by half the change of thickness. A thickness that
+        //! is not greater than 0 is rejected.
+        void set_ply_thickness(std::size_t i, double thickness);
+};
+
+#endif
\ No newline at end of file
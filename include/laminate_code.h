@@ -0,0 +1,182 @@
+/**
+ * Extended laminate codes, parsed by recursive descent into a compact AST
+ * that is never expanded. The grammar (items are separated by "/", "," or
+ * spaces):
+ *      code      = "[" sequence "]" subscript
+ *      sequence  = item { item }
+ *      item      = element [ "_" count ]
+ *      element   = angle [ "bar" ]             single ply, e.g. 0_3
+ *                | ( "±" | "+-" ) angle        pair +angle/-angle, e.g. ±45
+ *                | ( "∓" | "-+" ) angle        pair -angle/+angle
+ *                | "(" sequence ")" [ count ]  group, e.g. (0/90)2
+ *      subscript = [ count ] [ "s" [ count ] ]
+ * e.g. `[(0/90)2/±45_2]s`, or `[0/45/90bar]s` in which the barred 90 ply is
+ * the mid-plane ply: it is not mirrored, so the code stands for 0/45/90/45/0.
+ * The barred ply must be the last item of a symmetric code without a count
+ * before the 's'. A repeated pair repeats the whole pair, ±45_2 is
+ * 45/-45/45/-45.
+ *
+ * The ply count, the symmetry and the balance come from the AST in time
+ * proportional to the length of the code, so a million-ply stack is described
+ * and validated without building its plies. for_each_ply walks the plies
+ * lazily, from the bottom ply to the top ply. Codes whose groups are nested
+ * deeper than kMaxCodeDepth, or whose ply count does not fit in 64 bits, are
+ * rejected by the parser.
+ */
+
+#ifndef LAMINATE_CODE_H
+#define LAMINATE_CODE_H
+
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+#include "layup.h"
+
+//! Maximum nesting depth of the groups of a laminate code. The parser and
+//! the walks recurse once per level.
+constexpr int kMaxCodeDepth = 64;
+
+enum class CodeNodeKind { ply, pair, group };
+
+//! A node of the laminate code AST. The nodes are stored in pre-order, so the
+//! children of a group are the nodes that follow it, and size skips a whole
+//! subtree.
+struct CodeNode {
+    CodeNodeKind kind;
+    //! The angle of a ply, or the first angle of a pair. Unused by groups.
+    double angle;
+    int repeat;
+    //! The number of nodes of the subtree, including this node.
+    int size;
+    //! The index of the written angle (ply or pair) in the code, which picks
+    //! the material and the thickness of the plies. -1 for groups.
+    int leaf;
+    //! The index of the previous child of the same group, or -1 for the first
+    //! child and the root. Lets reversed walks go backwards without a stack.
+    int previous;
+};
+
+struct laminate_code {
+    //! The AST. Node 0 is the group inside the brackets, and its repeat is the
+    //! pre_count of the subscript.
+    std::vector<CodeNode> nodes_;
+    SubscriptInfo subscript_;
+
+    //! True if the last item of the brackets is the barred mid-plane ply.
+    bool has_mid_ply_;
+
+    //! The number of written angles, i.e. of material and thickness entries.
+    int leaf_count_;
+
+    //! The total number of plies of the laminate. parse_laminate_code checks
+    //! that it fits in std::uint64_t.
+    std::uint64_t ply_count() const;
+
+    //! The total number of plies in count. Returns false if it overflows.
+    bool checked_ply_count(std::uint64_t& count) const;
+
+    //! True if the code has the 's' subscript.
+    bool is_symmetric() const;
+
+    //! True if every off-axis angle has as many plies as its negative.
+    //! Materials and thicknesses are not compared. False if a count 
+    //! overflows, which the parser does not let happen.
+    bool is_balanced() const;
+
+    //! Call visit(angle, leaf) for every ply, from the bottom ply to the top
+    //! ply, without building the stack.
+    template <typename Visit>
+    void for_each_ply(Visit visit) const;
+
+    //! Number of plies of the subtree at node, including its repeat, in
+    //! count. Returns false if it overflows.
+    bool node_ply_count(int node, std::uint64_t& count) const;
+
+    //! Visit the plies of the subtree at node, in reverse order if reverse.
+    template <typename Visit>
+    void walk(int node, bool reverse, Visit& visit) const;
+
+    //! Visit the children of the group at node. The last child is skipped if
+    //! skip_last.
+    template <typename Visit>
+    void walk_children(int node, bool reverse, bool skip_last,
+                       Visit& visit) const;
+};
+
+//! Parse an extended laminate code into result. Returns false and prints the
+//! reason if the code is invalid.
+bool parse_laminate_code(std::string_view code, laminate_code& result);
+
+//! True if the code uses a feature of the extended grammar (groups, "_"
+//! counts, pairs or a barred ply), which the plain [0/45/-45/90]2s2 parser
+//! does not understand.
+bool is_extended_code(std::string_view code);
+
+template <typename Visit>
+void laminate_code::for_each_ply(Visit visit) const {
+    int post_count = subscript_.post_count > 0 ? subscript_.post_count : 1;
+    for (int i = 0; i < post_count; i++) {
+        if (subscript_.has_symmetry) {
+            for (int r = 0; r < nodes_[0].repeat; r++) {
+                walk_children(0, false, has_mid_ply_, visit);
+            }
+            if (has_mid_ply_) {
+                walk(nodes_.size() - 1, false, visit);
+            }
+            for (int r = 0; r < nodes_[0].repeat; r++) {
+                walk_children(0, true, has_mid_ply_, visit);
+            }
+        } else {
+            walk(0, false, visit);
+        }
+    }
+}
+
+template <typename Visit>
+void laminate_code::walk(int node, bool reverse, Visit& visit) const {
+    const CodeNode& n = nodes_[node];
+    for (int r = 0; r < n.repeat; r++) {
+        switch (n.kind) {
+            case CodeNodeKind::ply:
+                visit(n.angle, n.leaf);
+                break;
+            case CodeNodeKind::pair:
+                visit(reverse ? -n.angle : n.angle, n.leaf);
+                visit(reverse ? n.angle : -n.angle, n.leaf);
+                break;
+            case CodeNodeKind::group:
+                walk_children(node, reverse, false, visit);
+                break;
+        }
+    }
+}
+
+template <typename Visit>
+void laminate_code::walk_children(int node, bool reverse, bool skip_last,
+                                  Visit& visit) const {
+    int end = node + nodes_[node].size;
+    if (skip_last) {
+        // Only the root skips its last child, the barred ply, which is the
+        // last node.
+        end--;
+    }
+    if (node + 1 >= end) {
+        return;
+    }
+    if (reverse) {
+        int last = node + 1;
+        while (last + nodes_[last].size < end) {
+            last += nodes_[last].size;
+        }
+        for (int c = last; c != -1; c = nodes_[c].previous) {
+            walk(c, true, visit);
+        }
+    } else {
+        for (int c = node + 1; c < end; c += nodes_[c].size) {
+            walk(c, false, visit);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,97 @@
+/**
+ * Reusable laminate solver for hot loops (e.g. the integration points of a 
+ * finite element model). All buffers are allocated once, for a maximum ply
+ * count, when the solver is constructed; editing plies and solving afterwards
+ * do no heap allocation. Plies are stored without their material label, and 
+ * Qbar is computed directly from the material invariants instead of going 
+ * through the Qbar cache.
+ *
+ * Typical use: parse the input once with get_ply_vector, load the plies into
+ * the solver, then call set_ply_angle / set_ply_thickness and solve as often
+ * as needed.
+ */
+
+#ifndef LAMINATE_SOLVER_H
+#define LAMINATE_SOLVER_H
+
+#include <Eigen/Dense>
+#include <vector>
+#include <cstddef>
+
+#include "ply.h"
+#include "abd_solver.h"
+#include "laminate.h"
+
+struct laminate_solver {
+    //! Maximum number of plies.
+    std::size_t capacity_;
+
+    //! Number of plies currently in the laminate.
+    std::size_t ply_count_;
+
+    //! Properties, invariants, orientation, thickness, Qbar, Qs and the 
+    //! expansion vectors (see ply) of each ply, from bottom to top. Only the
+    //! first ply_count_ entries are in use.
+    std::vector<Properties> properties_;
+    std::vector<Invariants> invariants_;
+    std::vector<double> theta_;
+    std::vector<double> thickness_;
+    std::vector<Eigen::Matrix3d> Qbar_;
+    std::vector<Eigen::Matrix2d> Qs_;
+    std::vector<Eigen::Vector3d> alpha_;
+    std::vector<Eigen::Vector3d> beta_;
+
+    //! Results of the last solve, with the same meaning as in laminate.
+    double height_;
+    Eigen::Matrix3d A_;
+    Eigen::Matrix3d B_;
+    Eigen::Matrix3d D_;
+    Eigen::Matrix2d S0_;
+    Eigen::Matrix2d S1_;
+    Eigen::Matrix2d S2_;
+    Eigen::Matrix2d As_;
+    Eigen::Vector3d NT_;
+    Eigen::Vector3d MT_;
+    Eigen::Vector3d NH_;
+    Eigen::Vector3d MH_;
+    ABDCompliance compliance_;
+    EngineeringConstants engineering_constants_;
+    Eigen::Vector3d mid_strain_;
+    Eigen::Vector3d mid_curvature_;
+
+    //! Profile of the last solve, one segment per ply. Only the first 
+    //! ply_count_ entries are in use.
+    std::vector<PlySegment> profile_segments_;
+
+    //! Allocate the buffers for up to capacity plies. The laminate is empty.
+    explicit laminate_solver(std::size_t capacity);
+
+    //! Replace the plies with ply_vector. Returns false, and leaves the 
+    //! laminate unchanged, if ply_vector has more plies than the capacity.
+    bool set_plies(const std::vector<ply>& ply_vector);
+
+    //! Same as above, from plies given by value (e.g. by get_lamina_vector).
+    //! Qbar, Qs and the expansion vectors are computed here.
+    bool set_plies(const std::vector<BasicLamina<double>>& plies);
+
+    //! Set the i-th ply (counting from the bottom). i must be less than the
+    //! ply count.
+    void set_ply(std::size_t i, const Properties& material_properties, 
+                 double theta, double thickness);
+
+    //! Change the fiber orientation of the i-th ply.
+    void set_ply_angle(std::size_t i, double theta);
+
+    //! Change the thickness of the i-th ply. Returns false, and leaves the 
+    //! ply unchanged, if thickness is not greater than 0 or not finite.
+    bool set_ply_thickness(std::size_t i, double thickness);
+
+    //! Assemble A_, B_, D_, As_ and the expansion resultants, and solve the
+    //! mid-plane strains, curvatures and the profile segments for 
+    //! load_vector with a temperature change delta_T and a moisture change
+    //! delta_C.
+    void solve(const Eigen::Matrix<double, 6, 1>& load_vector,
+               double delta_T = 0., double delta_C = 0.);
+};
+
+#endif
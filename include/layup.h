@@ -0,0 +1,84 @@
+/**
+ * Run-length compressed representation of a laminate stack. A laminate code
+ * such as `[0/45/-45/90]8s4` is kept as its base sequence of plies and its
+ * subscript, instead of the fully expanded vector of plies. The A, B, D 
+ * submatrices are composed in closed form from the contribution of the base 
+ * sequence, so both memory and ABD time scale with the number of unique plies
+ * rather than the total number of plies.
+ */
+
+#ifndef LAYUP_H
+#define LAYUP_H
+
+#include <Eigen/Dense>
+#include <vector>
+#include <cstddef>
+
+#include "ply.h"
+
+//! The subscript of the laminate code. e.g. [0/45/45/90]8s4. 8 is the pre_count,
+//! s is the has_symmetry, and 4 is the post_count.
+struct SubscriptInfo {
+    int pre_count;
+    bool has_symmetry;
+    int post_count;
+};
+
+//! The stiffness contribution of a contiguous block of plies, about the 
+//! mid-plane of the block (see BasicBlockStiffness).
+using BlockStiffness = BasicBlockStiffness<double>;
+
+//! Sum the contribution of the given plies, from bottom to top, into a block.
+BlockStiffness ply_block_stiffness(const std::vector<ply>& plies);
+
+//! Move the reference plane of the block by offset. A block whose mid-plane
+//! lies at z = offset has the returned B and D about z = 0.
+BlockStiffness shift_block(const BlockStiffness& block, double offset);
+
+//! Place the upper block on top of the lower block.
+BlockStiffness stack_blocks(const BlockStiffness& lower, 
+                            const BlockStiffness& upper);
+
+//! Reverse the stacking order of the block.
+BlockStiffness mirror_block(const BlockStiffness& block);
+
+//! Stack count copies of the block on top of each other.
+BlockStiffness repeat_block(const BlockStiffness& block, int count);
+
+//! Number of plies of a laminate of base_count plies expanded by subscript.
+std::size_t expanded_ply_count(const SubscriptInfo& subscript, 
+                               std::size_t base_count);
+
+//! Index in the base sequence of the i-th ply (counting from the bottom) of 
+//! the expanded laminate.
+std::size_t base_ply_index(const SubscriptInfo& subscript, 
+                           std::size_t base_count, std::size_t i);
+
+//! A laminate stored as its base ply sequence and the repetition/symmetry
+//! subscript that expands it.
+struct layup {
+    //! The plies inside the square brackets of the laminate code, from 
+    //! bottom to top.
+    std::vector<ply> base_plies_;
+
+    //! Repetition and symmetry of the base sequence.
+    SubscriptInfo subscript_;
+
+    layup(const std::vector<ply>& base_plies, const SubscriptInfo& subscript);
+
+    //! Total number of plies of the expanded laminate.
+    std::size_t ply_count() const;
+
+    //! The i-th ply of the expanded laminate (counting from the bottom), 
+    //! found without expanding the laminate.
+    const ply& ply_at(std::size_t i) const;
+
+    //! A, B, D submatrices of the whole laminate about its mid-plane, composed
+    //! from the base sequence in closed form.
+    BlockStiffness stiffness() const;
+
+    //! Expand into a vector of plies, from the bottom ply to the top ply.
+    std::vector<ply> expand() const;
+};
+
+#endif
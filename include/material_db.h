@@ -0,0 +1,59 @@
+/**
+ * Binary material database, compiled from the text `material_data` file. The
+ * file is a header followed by fixed-size records sorted by label:
+ *      header: magic "LMCMATDB" (8 bytes), record size (uint32), record
+ *              count (uint32)
+ *      record: label (32 bytes, NUL padded), then E1, E2, nu12, G12, G13, G23,
+ *              alpha1, alpha2, beta1, beta2 (10 doubles)
+ * Numbers are stored in the byte order of the machine that compiled the file.
+ * The file is memory mapped and a label is found by binary search, so opening
+ * the database does not depend on the number of materials, and only the
+ * records of the looked-up labels are read.
+ */
+
+#ifndef MATERIAL_DB_H
+#define MATERIAL_DB_H
+
+#include <map>
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+
+#include "ply.h"
+
+//! Bytes reserved for the label of a record, including the terminating NUL.
+constexpr std::size_t kMaterialLabelSize = 32;
+
+//! A read-only, memory-mapped material database.
+struct material_db {
+    const char* data_;
+    std::size_t size_;
+    std::uint32_t count_;
+
+    //! Map the database file. is_open() is false if the file cannot be mapped
+    //! or is not a material database.
+    explicit material_db(const std::string& filename);
+    ~material_db();
+    material_db(const material_db&) = delete;
+    material_db& operator=(const material_db&) = delete;
+
+    bool is_open() const;
+
+    //! Store the properties of the material label into p. Returns false if
+    //! the label is not in the database.
+    bool find(std::string_view label, Properties& p) const;
+
+    //! Read every material of the database.
+    std::map<std::string, Properties> all() const;
+};
+
+//! True if the file starts with the magic number of a material database.
+bool is_material_db(const std::string& filename);
+
+//! Write the materials into a database file. Returns false if a label is too
+//! long or the file cannot be written.
+bool write_material_db(const std::map<std::string, Properties>& materials,
+                       const std::string& filename);
+
+#endif
@@ -0,0 +1,53 @@
+/**
+ * Splitting of a loop over [0, count) into contiguous ranges, one per
+ * thread. Each thread writes only the slots of its own range, so the results
+ * do not depend on the number of threads.
+ */
+
+#ifndef PARALLEL_RANGES_H
+#define PARALLEL_RANGES_H
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+//! Loops with more work items than this run in parallel by default.
+constexpr std::size_t kParallelThreshold = 1 << 16;
+
+//! The number of threads for work_size items when the caller asks for
+//! thread_count threads: 0 is one thread per hardware thread if work_size is
+//! larger than threshold, and one thread otherwise.
+inline unsigned parallel_thread_count(unsigned thread_count,
+                                      std::size_t work_size,
+                                      std::size_t threshold) {
+    if (thread_count == 0) {
+        thread_count = work_size > threshold
+            ? std::max(std::thread::hardware_concurrency(), 1u) : 1;
+    }
+    return thread_count;
+}
+
+//! Call fn(begin, end) on thread_count contiguous ranges that cover
+//! [0, count), each on its own thread, and wait for all of them. There are
+//! never more ranges than items, and a single range runs on the calling
+//! thread.
+template <typename Function>
+void parallel_ranges(std::size_t count, unsigned thread_count, Function fn) {
+    thread_count = std::min<std::size_t>(std::max(thread_count, 1u),
+                                         std::max<std::size_t>(count, 1));
+    if (thread_count == 1) {
+        fn(std::size_t(0), count);
+        return;
+    }
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < thread_count; t++) {
+        threads.emplace_back(fn, count * t / thread_count,
+                             count * (t + 1) / thread_count);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+#endif
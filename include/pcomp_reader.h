@@ -0,0 +1,95 @@
+/**
+ * Reader for the composite shell properties of a Nastran bulk data deck. The
+ * PCOMP cards give the plies of each property and the MAT8 cards give their
+ * orthotropic materials:
+ *      PCOMP  PID   Z0    NSM   SB    FT    TREF  GE    LAM
+ *             MID1  T1    THETA1 SOUT1 MID2 T2    THETA2 SOUT2 ...
+ *      MAT8   MID   E1    E2    NU12  G12   G1Z   G2Z   RHO
+ *             A1    A2    TREF  Xt    Xc    Yt    Yc    S
+ * Both the small fixed-field format (8 characters per field) and the free-
+ * field format (fields separated by commas) are read, and a tab is read as a
+ * field separator. A card continues on the following lines whose first field
+ * is blank or starts with '+' or '*'. Lines starting with '$' are comments.
+ * Reals may use the Nastran short exponent, e.g. 1.5+7 or 7.-3. If the deck
+ * has a BEGIN BULK line (in any case, and not in a comment), only the lines
+ * between it and ENDDATA are read.
+ *
+ * A blank MIDi or Ti repeats the value of the ply below, and a blank THETAi is
+ * 0; a ply thickness that is not positive makes the card invalid. LAM = SYM
+ * lists only the plies below the mid-plane, from the bottom ply; the other
+ * LAM options are not supported. G1Z, G2Z, A1 and A2 of the MAT8 card are
+ * the G13, G23, alpha1 and alpha2 of the ply.
+ *
+ * evaluate_pcomps assembles the A, B, D submatrices of all the cards in
+ * parallel, about the reference plane of the shell, i.e. the mid-plane
+ * shifted by Z0 + h/2, where Z0 (-h/2 if blank) is the offset of the bottom
+ * surface from the reference plane.
+ */
+
+#ifndef PCOMP_READER_H
+#define PCOMP_READER_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ply.h"
+#include "layup.h"
+
+//! A ply of a PCOMP card, with the material id of its MAT8 card.
+struct PcompPly {
+    int mid;
+    double thickness;
+    double theta;
+};
+
+//! A PCOMP card.
+struct PcompCard {
+    int pid;
+
+    //! Offset of the bottom surface from the reference plane. Only used if
+    //! has_z0.
+    double z0;
+    bool has_z0;
+
+    //! LAM = SYM: plies holds the plies below the mid-plane.
+    bool symmetric;
+
+    //! False if the card uses an unsupported option.
+    bool supported;
+
+    std::vector<PcompPly> plies;
+};
+
+//! The PCOMP and MAT8 cards of a bulk data deck.
+struct NastranDeck {
+    std::vector<PcompCard> pcomps_;
+    std::map<int, Properties> materials_;
+};
+
+//! The stiffness of a PCOMP card about the reference plane of the shell.
+struct PcompResult {
+    int pid;
+    BlockStiffness stiffness;
+
+    //! False if the card is unsupported or references an unknown material.
+    bool valid;
+};
+
+//! Read the PCOMP and MAT8 cards of the bulk data file into deck. Returns
+//! false if the file cannot be opened. Invalid cards, and cards whose PID or
+//! MID is already in the deck, are reported and skipped.
+bool read_nastran_deck(const std::string& filename, NastranDeck& deck);
+
+//! Evaluate the stiffness of every PCOMP card of the deck, in the order of
+//! the cards. thread_count 0 uses one thread per hardware thread.
+std::vector<PcompResult> evaluate_pcomps(const NastranDeck& deck,
+                                         unsigned thread_count = 0);
+
+//! Write one row per valid result: PID, the total thickness, then A11, A12,
+//! A16, A22, A26, A66 and the same entries of B and D. Returns the number of
+//! rows, or -1 if the file cannot be opened.
+long long write_pcomp_results(const std::vector<PcompResult>& results,
+                              const std::string& filename);
+
+#endif
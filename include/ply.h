@@ -11,46 +11,57 @@
 #include <utility>
 #include <string>
 
-//! Material properties of a composite ply.
-struct Properties {
-    
-    //! Young's modulus in the first principle direction.
-    double E1;
+#include "clt_core.h"
 
-    //! Young's modulus in the second principle direction.
-    double E2;
+//! Material properties of a composite ply.
+using Properties = BasicProperties<double>;
 
-    //! Poisson's ration in the 12 direction.
-    double nu12;
+//! Material invariants of the in-plane stiffness.
+using Invariants = BasicInvariants<double>;
 
-    //! Shear modulus in the 12 direction.
-    double G12;
+//! Position of each unique entry of the symmetric Qbar in packed (one column 
+//! per entry) layouts.
+enum QbarEntry { kQ11 = 0, kQ12, kQ16, kQ22, kQ26, kQ66 };
 
-};
+//! Position of each unique entry of the symmetric transverse shear stiffness
+//! Qs in packed layouts.
+enum QsEntry { kQ44 = 0, kQ45, kQ55 };
 
 //! Ply struct contains information of a ply (unidirectional lamina for a given
 //! layout orientation.)
 struct ply {
 
+    // The members are not const so that a laminate can replace one of its
+    // plies in place when a ply is edited.
+
     //! The material name of the ply
-    const std::string material_label_;
+    std::string material_label_;
 
     //! The material properties of the ply
-    const Properties material_properties_;
+    Properties material_properties_;
 
     //! Ply fiber orientation
-    const double theta_;
+    double theta_;
 
     //! Thickness of the ply.
-    const double thickness_;
+    double thickness_;
 
     //! The stiffness matrix in the laminate coordinates.
-    //! Note: setting Eigen Matrix to const will induce more complicate behaviors,
-    //! so here Eigen is not used.
     Eigen::Matrix3d Qbar_;
+
+    //! The transverse shear stiffness [Q44 Q45; Q45 Q55] in the laminate
+    //! coordinates.
+    Eigen::Matrix2d Qs_;
+
+    //! Free thermal strain per unit temperature change, and free moisture 
+    //! strain per unit moisture change, in the laminate coordinates 
+    //! (epsilon_x, epsilon_y, epsilon_xy).
+    Eigen::Vector3d alpha_;
+    Eigen::Vector3d beta_;
     
     // Ply constructor to read in material properties, ply orientations, 
     // thickness, and calculate the stiffness matrix in the laminate coordinates.
+    // The stiffness matrix is looked up in the Qbar cache (qbar_cache.h).
     ply(const std::string material_label, const Properties material_properties, 
         const double theta, const double thickness);
 };
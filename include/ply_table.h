@@ -0,0 +1,76 @@
+/**
+ * Struct-of-arrays table of the plies of a laminate. Only the data needed to
+ * assemble the A, B, D submatrices is kept: the interface coordinates, the 
+ * thicknesses, the 6 unique entries of each symmetric Qbar, the 3 of each
+ * transverse shear stiffness Qs and the products Qbar alpha and Qbar beta of
+ * the expansion coefficients, each in a contiguous aligned array. The ABD
+ * kernel works on whole columns of the table, so Eigen vectorizes it with the
+ * instruction set enabled at compile time (SSE2 by default on x86-64,
+ * AVX/AVX2 with e.g. `-march=native`).
+ *
+ * The accumulation is deterministic: the plies are split into fixed-size 
+ * chunks whose partial sums are combined in chunk order with compensated 
+ * summation, so the result is bitwise identical for any number of threads.
+ */
+
+#ifndef PLY_TABLE_H
+#define PLY_TABLE_H
+
+#include <Eigen/Dense>
+#include <vector>
+#include <cstddef>
+
+#include "ply.h"
+#include "layup.h"
+
+//! Running sum with Neumaier compensation.
+struct CompensatedSum {
+    double sum;
+    double compensation;
+
+    void add(double value);
+    double value() const;
+};
+
+struct ply_table {
+    //! Coordinates of the ply interfaces from the bottom surface to the top 
+    //! surface, measured from the mid-plane. Has one more entry than plies.
+    //! Each coordinate comes from a compensated prefix sum of the thicknesses
+    //! rather than a running sum, so it does not drift with the ply count.
+    Eigen::ArrayXd z_;
+
+    //! Thickness of each ply, from bottom to top.
+    Eigen::ArrayXd thickness_;
+
+    //! One row per ply, one column per unique Qbar entry (see QbarEntry).
+    Eigen::Matrix<double, Eigen::Dynamic, 6> qbar_;
+
+    //! One row per ply, one column per unique Qs entry (see QsEntry).
+    Eigen::Matrix<double, Eigen::Dynamic, 3> qs_;
+
+    //! One row per ply: Qbar alpha (x, y, xy) in the first three columns and
+    //! Qbar beta in the last three.
+    Eigen::Matrix<double, Eigen::Dynamic, 6> q_expansion_;
+
+    //! Build the table from plies ordered from bottom to top.
+    explicit ply_table(const std::vector<ply>& plies);
+
+    //! Number of plies.
+    std::size_t size() const;
+};
+
+//! Rebuild a symmetric 3x3 matrix from its unique entries in QbarEntry order.
+Eigen::Matrix3d unpack_symmetric(const Eigen::Matrix<double, 6, 1>& entries);
+
+//! Rebuild a symmetric 2x2 matrix from its unique entries in QsEntry order.
+Eigen::Matrix2d unpack_shear(const Eigen::Matrix<double, 3, 1>& entries);
+
+//! Accumulate the A, B, D submatrices, the shear moments and the thermal and
+//! moisture resultants of all plies of the table about its
+//! mid-plane, with thread_count threads. A thread_count of 0 uses one thread
+//! for small tables and all hardware threads for large ones. The result does
+//! not depend on thread_count.
+BlockStiffness accumulate_abd(const ply_table& table, 
+                              unsigned thread_count = 0);
+
+#endif
@@ -0,0 +1,92 @@
+/**
+ * A lazy view over the stress and strain profile of a laminate. Samples are 
+ * equally spaced through the thickness and each one is computed on demand 
+ * from the mid-plane strain, the curvature and the Qbar of the ply it lies in,
+ * so a profile of any density can be streamed with constant memory. 
+ *
+ * The coordinate of each sample is computed from its index, and the ply of a
+ * sample is found by binary search over the ply interfaces, so any range of
+ * samples can be evaluated independently (see laminate::sample_profile).
+ */
+
+#ifndef PROFILE_VIEW_H
+#define PROFILE_VIEW_H
+
+#include <Eigen/Dense>
+#include <cstddef>
+#include <iterator>
+
+#include "laminate.h"
+
+//! One sampling point of the profile.
+struct ProfileSample {
+    //! Coordinate of the sampling point.
+    double pt;
+
+    //! Stresses (sigma_x, sigma_y, sigma_xy) at the sampling point.
+    Eigen::Vector3d stress;
+
+    //! Strains (epsilon_x, epsilon_y, epsilon_xy) at the sampling point.
+    Eigen::Vector3d strain;
+};
+
+//! Range of profile samples, pt_spacing apart from the bottom to the top of 
+//! the laminate. The last sample is clamped to the top surface, and a point on
+//! an interface belongs to the ply below it. The laminate must outlive the 
+//! view. A pt_spacing that is not greater than 0 is reported and gives an
+//! empty view.
+struct profile_view {
+    
+    //! Input iterator computing one sample per dereference. Samples are 
+    //! returned by value, so there is no operator->.
+    struct iterator {
+        using iterator_category = std::input_iterator_tag;
+        using value_type = ProfileSample;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = ProfileSample;
+
+        const profile_view* view_;
+
+        //! Index of the current sample.
+        std::size_t index_;
+
+        //! Index of the ply containing the current sample.
+        std::size_t layer_;
+
+        ProfileSample operator*() const;
+        iterator& operator++();
+        iterator operator++(int);
+        bool operator==(const iterator& other) const;
+        bool operator!=(const iterator& other) const;
+    };
+
+    const laminate* lam_;
+    double pt_spacing_;
+
+    //! Number of intervals between samples; the view has one more sample.
+    std::size_t interval_count_;
+
+    profile_view(const laminate& lam, double pt_spacing);
+
+    //! Number of samples.
+    std::size_t size() const;
+
+    //! Coordinate of the i-th sample.
+    double pt(std::size_t i) const;
+
+    //! Index of the ply containing the coordinate pt, found by binary search.
+    std::size_t layer_of(double pt) const;
+
+    //! The i-th sample. Requires i < size() (asserted); at() is the checked
+    //! access.
+    ProfileSample operator[](std::size_t i) const;
+
+    //! Iterator to the i-th sample, or end() if i is not less than size().
+    iterator at(std::size_t i) const;
+
+    iterator begin() const;
+    iterator end() const;
+};
+
+#endif
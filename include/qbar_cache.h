@@ -0,0 +1,61 @@
+/**
+ * Process-wide cache of transformed ply stiffness matrices. Real layups reuse
+ * a few (material, orientation) pairs many times, so the Qbar and Qs of each
+ * pair are computed once and looked up afterwards. Materials are interned:
+ * each distinct (label, properties) pair gets a small integer id, and the
+ * cache is keyed by (material id, angle). The cache holds at most
+ * kQbarCacheCapacity entries and is emptied when it is full, so a sweep over
+ * many distinct angles does not grow it without bound. The material table 
+ * holds at most kQbarCacheMaterials materials; when a new one does not fit,
+ * the table and the cache are both emptied. Non-finite angles are never 
+ * cached. All functions are thread-safe.
+ *
+ * Only the ply constructor goes through the cache. The batch engines 
+ * (batch_runner, batch_screen, laminate_solver and the PCOMP evaluation) 
+ * build Qbar directly on purpose: their cases come from many threads and 
+ * sweep many angles, where the shared lock and the table would cost more 
+ * than the transform they save.
+ */
+
+#ifndef QBAR_CACHE_H
+#define QBAR_CACHE_H
+
+#include <Eigen/Dense>
+#include <string>
+#include <cstddef>
+
+#include "ply.h"
+
+//! Maximum number of entries held by the Qbar cache.
+constexpr std::size_t kQbarCacheCapacity = 1 << 14;
+
+//! Maximum number of materials interned by the Qbar cache.
+constexpr std::size_t kQbarCacheMaterials = 1 << 10;
+
+//! The transformed in-plane and transverse shear stiffness of a ply.
+struct CachedStiffness {
+    Eigen::Matrix3d Qbar;
+    Eigen::Matrix2d Qs;
+};
+
+//! Hit and miss counters of the Qbar cache, and the number of interned 
+//! materials.
+struct QbarCacheStats {
+    std::size_t hits;
+    std::size_t misses;
+    std::size_t materials;
+};
+
+//! Intern the material and return its Qbar and Qs at the angle theta (in
+//! degrees), taking the cache lock once. The same label with different 
+//! properties is a different material.
+CachedStiffness cached_stiffness(const std::string& label, const Properties& p,
+                                 double theta);
+
+//! Current hit and miss counts of the cache.
+QbarCacheStats qbar_cache_stats();
+
+//! Remove all cached entries and interned materials, and reset the counters.
+void clear_qbar_cache();
+
+#endif
@@ -0,0 +1,69 @@
+/**
+ * Single-pass tokenizer for the text inputs. Tokens are std::string_view 
+ * slices of the input line, so nothing is copied, and numbers are converted
+ * with std::from_chars, which is locale independent and does not go through a
+ * stream.
+ */
+
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include <iosfwd>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+//! Delimiters of numeric lists, e.g. [0/45/-45/90] or [7e6, 0, 0].
+constexpr std::string_view kNumberDelimiters = " \t\r,/";
+
+//! Delimiters of label lists. A forward slash may be part of a material label.
+constexpr std::string_view kLabelDelimiters = " \t\r,";
+
+//! Iterates the tokens of a text split at any of the delimiter characters.
+//! Runs of delimiters are skipped, so there are no empty tokens.
+struct tokenizer {
+    std::string_view text_;
+    std::string_view delimiters_;
+
+    //! Position of the next character to read.
+    std::size_t pos_;
+
+    tokenizer(std::string_view text, std::string_view delimiters);
+
+    //! Store the next token into token. Returns false at the end of the text.
+    bool next(std::string_view& token);
+};
+
+//! The text between the first '[' and the first ']' after it. Empty if there
+//! is no such pair.
+std::string_view bracket_contents(std::string_view text);
+
+//! The text after the first ']' (e.g. the subscript of a laminate code).
+//! Empty if there is no ']'.
+std::string_view after_bracket(std::string_view text);
+
+//! Convert a whole token into a number. A leading '+' is accepted. Returns 
+//! false if the token is not a number.
+bool parse_number(std::string_view token, float& value);
+bool parse_number(std::string_view token, double& value);
+bool parse_number(std::string_view token, long double& value);
+bool parse_number(std::string_view token, int& value);
+
+//! Append the numbers of the text to values, converted directly in the 
+//! precision of Number (float, double or long double). Stops at the first 
+//! token that is not a number and returns false in that case.
+template <typename Number>
+bool parse_numbers(std::string_view text, std::vector<Number>& values,
+                   std::string_view delimiters = kNumberDelimiters);
+
+//! The stream the text parsers (input_parser, laminate_code) print their 
+//! error messages to: std::cout, unless the calling thread redirected them
+//! with set_parser_messages.
+std::ostream& parser_messages();
+
+//! Send the error messages of the parsers on the calling thread to messages,
+//! or back to std::cout if messages is nullptr. Worker threads use it to keep
+//! their messages in order with their results.
+void set_parser_messages(std::ostream* messages);
+
+#endif
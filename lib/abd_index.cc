@@ -0,0 +1,108 @@
+//! Implementation of the ABD prefix-sum index.
+
+#include <Eigen/Dense>
+#include <cstddef>
+#include <cassert>
+#include "../include/layup.h"
+#include "../include/ply_table.h"
+#include "../include/abd_index.h"
+
+using Eigen::Matrix;
+
+abd_index::abd_index(const ply_table& table):
+    z_(table.z_), A_prefix_(table.size() + 1, 6), 
+    B_prefix_(table.size() + 1, 6), D_prefix_(table.size() + 1, 6),
+    S0_prefix_(table.size() + 1, 3), S1_prefix_(table.size() + 1, 3),
+    S2_prefix_(table.size() + 1, 3), N_expansion_prefix_(table.size() + 1, 6),
+    M_expansion_prefix_(table.size() + 1, 6) {
+    A_prefix_.row(0).setZero();
+    B_prefix_.row(0).setZero();
+    D_prefix_.row(0).setZero();
+    S0_prefix_.row(0).setZero();
+    S1_prefix_.row(0).setZero();
+    S2_prefix_.row(0).setZero();
+    N_expansion_prefix_.row(0).setZero();
+    M_expansion_prefix_.row(0).setZero();
+    // One compensated running sum per unique entry of A, B, D and of the 
+    // shear moments.
+    CompensatedSum sums[3][6];
+    CompensatedSum shear_sums[3][3];
+    CompensatedSum expansion_sums[2][6];
+    for (auto& moment : sums) {
+        for (auto& entry : moment) {
+            entry = CompensatedSum{0., 0.};
+        }
+    }
+    for (auto& moment : shear_sums) {
+        for (auto& entry : moment) {
+            entry = CompensatedSum{0., 0.};
+        }
+    }
+    for (auto& moment : expansion_sums) {
+        for (auto& entry : moment) {
+            entry = CompensatedSum{0., 0.};
+        }
+    }
+    for (std::size_t i = 0; i < table.size(); i++) {
+        double t = table.thickness_(i);
+        double bottom = z_(i);
+        double top = z_(i + 1);
+        double weights[3] = {t, t * (top + bottom) / 2, 
+                             t * (top*top + top*bottom + bottom*bottom) / 3};
+        for (int j = 0; j < 6; j++) {
+            sums[0][j].add(table.qbar_(i, j) * weights[0]);
+            sums[1][j].add(table.qbar_(i, j) * weights[1]);
+            sums[2][j].add(table.qbar_(i, j) * weights[2]);
+            A_prefix_(i + 1, j) = sums[0][j].value();
+            B_prefix_(i + 1, j) = sums[1][j].value();
+            D_prefix_(i + 1, j) = sums[2][j].value();
+        }
+        for (int j = 0; j < 3; j++) {
+            shear_sums[0][j].add(table.qs_(i, j) * weights[0]);
+            shear_sums[1][j].add(table.qs_(i, j) * weights[1]);
+            shear_sums[2][j].add(table.qs_(i, j) * weights[2]);
+            S0_prefix_(i + 1, j) = shear_sums[0][j].value();
+            S1_prefix_(i + 1, j) = shear_sums[1][j].value();
+            S2_prefix_(i + 1, j) = shear_sums[2][j].value();
+        }
+        for (int j = 0; j < 6; j++) {
+            expansion_sums[0][j].add(table.q_expansion_(i, j) * weights[0]);
+            expansion_sums[1][j].add(table.q_expansion_(i, j) * weights[1]);
+            N_expansion_prefix_(i + 1, j) = expansion_sums[0][j].value();
+            M_expansion_prefix_(i + 1, j) = expansion_sums[1][j].value();
+        }
+    }
+}
+
+std::size_t abd_index::size() const {
+    return z_.size() - 1;
+}
+
+BlockStiffness abd_index::range(std::size_t begin, std::size_t end) const {
+    assert(begin <= end && end <= size());
+    BlockStiffness block;
+    block.height = z_(end) - z_(begin);
+    block.A = unpack_symmetric(
+        (A_prefix_.row(end) - A_prefix_.row(begin)).transpose());
+    block.B = unpack_symmetric(
+        (B_prefix_.row(end) - B_prefix_.row(begin)).transpose());
+    block.D = unpack_symmetric(
+        (D_prefix_.row(end) - D_prefix_.row(begin)).transpose());
+    block.S0 = unpack_shear(
+        (S0_prefix_.row(end) - S0_prefix_.row(begin)).transpose());
+    block.S1 = unpack_shear(
+        (S1_prefix_.row(end) - S1_prefix_.row(begin)).transpose());
+    block.S2 = unpack_shear(
+        (S2_prefix_.row(end) - S2_prefix_.row(begin)).transpose());
+    Matrix<double, 1, 6> N_expansion = 
+        N_expansion_prefix_.row(end) - N_expansion_prefix_.row(begin);
+    Matrix<double, 1, 6> M_expansion = 
+        M_expansion_prefix_.row(end) - M_expansion_prefix_.row(begin);
+    block.NT = N_expansion.head<3>().transpose();
+    block.NH = N_expansion.tail<3>().transpose();
+    block.MT = M_expansion.head<3>().transpose();
+    block.MH = M_expansion.tail<3>().transpose();
+    // The moments are about the laminate mid-plane, where the mid-plane of 
+    // the range lies at its mid-point.
+    return shift_block(block, -(z_(begin) + z_(end)) / 2);
+}
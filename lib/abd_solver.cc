@@ -0,0 +1,130 @@
+//! Implementation of the ABD solver.
+
+#include <Eigen/Dense>
+#include <cmath>
+#include "../include/abd_solver.h"
+
+// Relative size below which a coupling term is treated as round-off.
+const double kCouplingTolerance = 1e-12;
+
+// Reciprocal condition number below which the Cholesky factorization is not
+// trusted and the pivoted QR is used instead.
+const double kMinimumRcond = 1e-12;
+
+// Invert a symmetric 3x3 matrix in closed form. Returns false if the matrix 
+// is not positive definite.
+bool invert_symmetric_3x3(const Eigen::Matrix3d& M, Eigen::Matrix3d& inverse);
+
+// Invert A of a balanced laminate, in which the shear term is decoupled from
+// the normal terms. Returns false if the matrix is not positive definite.
+bool invert_balanced_3x3(const Eigen::Matrix3d& M, Eigen::Matrix3d& inverse);
+
+// Split a 6x6 compliance matrix into its submatrices.
+void split_compliance(const Eigen::Matrix<double, 6, 6>& full, 
+                      ABDCompliance& compliance);
+
+using Eigen::Matrix; using Eigen::Matrix3d;
+
+ABDCompliance invert_abd(const Matrix3d& A, const Matrix3d& B, 
+                         const Matrix3d& D) {
+    ABDCompliance compliance;
+    double A_max = A.cwiseAbs().maxCoeff();
+    double D_max = D.cwiseAbs().maxCoeff();
+    // B has the units of A times a length, so it is compared with the 
+    // geometric mean of A and D.
+    compliance.is_symmetric = B.cwiseAbs().maxCoeff() 
+        <= kCouplingTolerance * std::sqrt(A_max * D_max);
+    compliance.is_balanced = std::abs(A(0, 2)) <= kCouplingTolerance * A_max
+                          && std::abs(A(1, 2)) <= kCouplingTolerance * A_max;
+
+    if (compliance.is_symmetric) {
+        bool A_inverted = compliance.is_balanced 
+            ? invert_balanced_3x3(A, compliance.a)
+            : invert_symmetric_3x3(A, compliance.a);
+        if (A_inverted && invert_symmetric_3x3(D, compliance.d)) {
+            compliance.b = Matrix3d::Zero();
+            compliance.path = SolvePath::decoupled;
+            return compliance;
+        }
+    }
+
+    Matrix<double, 6, 6> stiffness;
+    stiffness << A, B,
+                 B, D;
+    Eigen::LLT<Matrix<double, 6, 6>> llt(stiffness);
+    if (llt.info() == Eigen::Success && llt.rcond() > kMinimumRcond) {
+        split_compliance(llt.solve(Matrix<double, 6, 6>::Identity()), 
+                         compliance);
+        compliance.path = SolvePath::cholesky;
+    } else {
+        split_compliance(stiffness.colPivHouseholderQr().inverse(), compliance);
+        compliance.path = SolvePath::pivoted_qr;
+    }
+    return compliance;
+}
+
+Matrix<double, 6, 6> compliance_matrix(const ABDCompliance& compliance) {
+    Matrix<double, 6, 6> full;
+    full << compliance.a, compliance.b,
+            compliance.b.transpose(), compliance.d;
+    return full;
+}
+
+EngineeringConstants engineering_constants(const ABDCompliance& compliance,
+                                           double height) {
+    const Matrix3d& a = compliance.a;
+    const Matrix3d& d = compliance.d;
+    double flexural = 12 / (height * height * height);
+    EngineeringConstants constants;
+    constants.Ex = 1 / (height * a(0, 0));
+    constants.Ey = 1 / (height * a(1, 1));
+    constants.Gxy = 1 / (height * a(2, 2));
+    constants.nuxy = -a(0, 1) / a(0, 0);
+    constants.nuyx = -a(0, 1) / a(1, 1);
+    constants.Efx = flexural / d(0, 0);
+    constants.Efy = flexural / d(1, 1);
+    constants.Gfxy = flexural / d(2, 2);
+    constants.nufxy = -d(0, 1) / d(0, 0);
+    constants.nufyx = -d(0, 1) / d(1, 1);
+    return constants;
+}
+
+bool invert_symmetric_3x3(const Matrix3d& M, Matrix3d& inverse) {
+    // Cofactors of the symmetric matrix; the determinant is expanded along
+    // the first row.
+    double c00 = M(1, 1) * M(2, 2) - M(1, 2) * M(1, 2);
+    double c01 = M(0, 2) * M(1, 2) - M(0, 1) * M(2, 2);
+    double c02 = M(0, 1) * M(1, 2) - M(0, 2) * M(1, 1);
+    double c22 = M(0, 0) * M(1, 1) - M(0, 1) * M(0, 1);
+    double det = M(0, 0) * c00 + M(0, 1) * c01 + M(0, 2) * c02;
+    // Sylvester's criterion: the leading minors M00, c22 and det are all
+    // positive.
+    if (!(M(0, 0) > 0 && c22 > 0 && det > 0)) {
+        return false;
+    }
+    double c11 = M(0, 0) * M(2, 2) - M(0, 2) * M(0, 2);
+    double c12 = M(0, 1) * M(0, 2) - M(0, 0) * M(1, 2);
+    inverse << c00, c01, c02,
+               c01, c11, c12,
+               c02, c12, c22;
+    inverse /= det;
+    return true;
+}
+
+bool invert_balanced_3x3(const Matrix3d& M, Matrix3d& inverse) {
+    double det = M(0, 0) * M(1, 1) - M(0, 1) * M(0, 1);
+    if (!(M(0, 0) > 0 && det > 0 && M(2, 2) > 0)) {
+        return false;
+    }
+    inverse << M(1, 1)/det, -M(0, 1)/det, 0,
+              -M(0, 1)/det,  M(0, 0)/det, 0,
+               0          ,  0          , 1/M(2, 2);
+    return true;
+}
+
+void split_compliance(const Matrix<double, 6, 6>& full, 
+                      ABDCompliance& compliance) {
+    compliance.a = full.block<3, 3>(0, 0);
+    compliance.b = full.block<3, 3>(0, 3);
+    compliance.d = full.block<3, 3>(3, 3);
+}
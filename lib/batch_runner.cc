@@ -0,0 +1,307 @@
+//! Implementation of the batch_runner.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <memory>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+#include <Eigen/Dense>
+#include "../include/batch_runner.h"
+#include "../include/input_parser.h"
+#include "../include/laminate_solver.h"
+#include "../include/tokenizer.h"
+#include "../include/material_db.h"
+
+// A chunk of consecutive lines of the batch file and, once solved, the result
+// rows of its cases and the error messages of its invalid cases.
+struct BatchChunk {
+    std::size_t sequence;
+    std::size_t first_line;
+    std::vector<std::string> lines;
+    std::string rows;
+    std::string messages;
+    long long solved;
+};
+
+// Queue between two stages of the pipeline. pop blocks until an item is
+// available, and returns false once the queue is closed and empty.
+template <typename T>
+struct batch_queue {
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<T> items_;
+    bool closed_ = false;
+
+    void push(T item);
+    void close();
+    bool pop(T& item);
+};
+
+// Counts the chunks in flight. The reader acquires a slot before reading a
+// chunk and the writer releases it after writing the chunk, which bounds the
+// memory of the whole pipeline.
+struct batch_window {
+    std::mutex mutex_;
+    std::condition_variable released_;
+    std::size_t free_;
+
+    void acquire();
+    void release();
+};
+
+// Solve the case of one line of the batch file and append its result row to
+// rows. Returns false, after printing the reason to parser_messages(), if the
+// case is invalid.
+bool solve_batch_case(std::string_view record, std::size_t line_number,
+                      const material_db* database,
+                      std::map<std::string, Properties>& material_data,
+                      laminate_solver& solver, std::ostream& rows);
+
+// Split a line of a batch file into its fields.
+std::vector<std::string> batch_fields(std::string_view record);
+
+// parse_batch_case on the fields of the line.
+bool parse_batch_fields(std::vector<std::string>& fields,
+                        const std::map<std::string, Properties>& material_data,
+                        BatchCase& batch_case);
+
+using std::cout; using std::endl;
+using std::string; using std::string_view; using std::vector; using std::map;
+
+long long run_batch(const string& batch_filename,
+                    const string& material_data_filename,
+                    const string& output_filename, unsigned thread_count) {
+    std::ifstream batch_file(batch_filename);
+    if (!batch_file.is_open()) {
+        cout << "Error: Cannot open file " << batch_filename << "." << endl;
+        return -1;
+    }
+    std::ofstream output_file(output_filename);
+    if (!output_file.is_open()) {
+        cout << "Error: Cannot open file " << output_filename << "." << endl;
+        return -1;
+    }
+    // The database stays mapped for the whole batch. Each worker keeps the
+    // materials it has read, starting from the ones of a text file.
+    map<string, Properties> material_data;
+    const std::unique_ptr<material_db> database =
+        open_material_data(material_data_filename, material_data);
+
+    if (thread_count == 0) {
+        thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    batch_queue<BatchChunk> read_chunks;
+    batch_queue<BatchChunk> solved_chunks;
+    batch_window window;
+    window.free_ = kBatchChunksPerThread * thread_count;
+
+    std::thread reader([&]() {
+        string line;
+        std::size_t line_number = 0;
+        for (std::size_t sequence = 0; batch_file; sequence++) {
+            window.acquire();
+            BatchChunk chunk{sequence, line_number + 1, {}, {}, {}, 0};
+            chunk.lines.reserve(kBatchChunkLines);
+            while (chunk.lines.size() < kBatchChunkLines
+                   && getline(batch_file, line)) {
+                chunk.lines.push_back(std::move(line));
+                line_number++;
+            }
+            read_chunks.push(std::move(chunk));
+        }
+        read_chunks.close();
+    });
+
+    std::atomic<unsigned> active_workers(thread_count);
+    vector<std::thread> workers;
+    for (unsigned t = 0; t < thread_count; t++) {
+        workers.emplace_back([&]() {
+            laminate_solver solver(64);
+            map<string, Properties> materials = material_data;
+            BatchChunk chunk;
+            while (read_chunks.pop(chunk)) {
+                // The messages are printed by the writer with the rows of
+                // the chunk, so they come out in file order.
+                std::ostringstream rows;
+                std::ostringstream messages;
+                set_parser_messages(&messages);
+                for (std::size_t i = 0; i < chunk.lines.size(); i++) {
+                    chunk.solved += solve_batch_case(chunk.lines[i],
+                        chunk.first_line + i, database.get(), materials,
+                        solver, rows);
+                }
+                set_parser_messages(nullptr);
+                chunk.lines.clear();
+                chunk.rows = rows.str();
+                chunk.messages = messages.str();
+                solved_chunks.push(std::move(chunk));
+            }
+            if (--active_workers == 0) {
+                solved_chunks.close();
+            }
+        });
+    }
+
+    // Chunks may be solved out of order; they are held until all earlier
+    // chunks are written. The window bounds their number.
+    long long solved = 0;
+    map<std::size_t, BatchChunk> pending;
+    std::size_t next_sequence = 0;
+    BatchChunk chunk;
+    while (solved_chunks.pop(chunk)) {
+        pending.emplace(chunk.sequence, std::move(chunk));
+        for (auto it = pending.find(next_sequence); it != pending.end();
+             it = pending.find(++next_sequence)) {
+            cout << it->second.messages;
+            output_file << it->second.rows;
+            solved += it->second.solved;
+            pending.erase(it);
+            window.release();
+        }
+    }
+
+    reader.join();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return solved;
+}
+
+template <typename T>
+void batch_queue<T>::push(T item) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        items_.push_back(std::move(item));
+    }
+    ready_.notify_one();
+}
+
+template <typename T>
+void batch_queue<T>::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+    }
+    ready_.notify_all();
+}
+
+template <typename T>
+bool batch_queue<T>::pop(T& item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ready_.wait(lock, [this]() { return !items_.empty() || closed_; });
+    if (items_.empty()) {
+        return false;
+    }
+    item = std::move(items_.front());
+    items_.pop_front();
+    return true;
+}
+
+void batch_window::acquire() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    released_.wait(lock, [this]() { return free_ > 0; });
+    free_--;
+}
+
+void batch_window::release() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        free_++;
+    }
+    released_.notify_one();
+}
+
+bool solve_batch_case(string_view record, std::size_t line_number,
+                      const material_db* database,
+                      map<string, Properties>& material_data,
+                      laminate_solver& solver, std::ostream& rows) {
+    if (!is_batch_record(record)) {
+        return false;
+    }
+    BatchCase batch_case;
+    if (!parse_batch_case(record, database, material_data, batch_case)) {
+        parser_messages() << "Error: invalid batch case at line " 
+                          << line_number << "." << endl;
+        return false;
+    }
+
+    if (batch_case.plies.size() > solver.capacity_) {
+        solver = laminate_solver(2 * batch_case.plies.size());
+    }
+    solver.set_plies(batch_case.plies);
+    solver.solve(batch_case.load, batch_case.delta_T, batch_case.delta_C);
+    const EngineeringConstants& constants = solver.engineering_constants_;
+    rows << line_number << ' ' << solver.mid_strain_.transpose() << ' '
+         << solver.mid_curvature_.transpose() << ' ' << constants.Ex << ' '
+         << constants.Ey << ' ' << constants.Gxy << ' ' << constants.nuxy
+         << '\n';
+    return true;
+}
+
+bool is_batch_record(string_view record) {
+    std::size_t first = record.find_first_not_of(" \t\r");
+    return first != string_view::npos && record[first] != '#';
+}
+
+bool parse_batch_case(string_view record,
+                      const map<string, Properties>& material_data,
+                      BatchCase& batch_case) {
+    vector<string> fields = batch_fields(record);
+    return parse_batch_fields(fields, material_data, batch_case);
+}
+
+bool parse_batch_case(string_view record, const material_db* database,
+                      map<string, Properties>& material_data,
+                      BatchCase& batch_case) {
+    vector<string> fields = batch_fields(record);
+    if (database != nullptr && fields.size() > 1) {
+        find_materials(*database, bracket_labels(fields[1]), material_data);
+    }
+    return parse_batch_fields(fields, material_data, batch_case);
+}
+
+vector<string> batch_fields(string_view record) {
+    vector<string> fields;
+    tokenizer field_tokens(record, ";");
+    string_view field;
+    while (field_tokens.next(field)) {
+        fields.emplace_back(field);
+    }
+    return fields;
+}
+
+bool parse_batch_fields(vector<string>& fields,
+                        const map<string, Properties>& material_data,
+                        BatchCase& batch_case) {
+    vector<double> load;
+    vector<double> environment{0., 0.};
+    bool valid = (fields.size() == 4 || fields.size() == 5)
+        && parse_numbers(bracket_contents(fields[3]), load)
+        && load.size() == 6;
+    if (valid && fields.size() == 5) {
+        environment.clear();
+        valid = parse_numbers(bracket_contents(fields[4]), environment)
+            && environment.size() == 2;
+    }
+    if (valid) {
+        batch_case.plies = get_lamina_vector(fields, material_data);
+        valid = !batch_case.plies.empty();
+    }
+    if (!valid) {
+        return false;
+    }
+    batch_case.load = Eigen::Matrix<double, 6, 1>(load.data());
+    batch_case.has_environment = fields.size() == 5;
+    batch_case.delta_T = environment[0];
+    batch_case.delta_C = environment[1];
+    return true;
+}
@@ -0,0 +1,332 @@
+//! Implementation of the single-precision batch screening.
+
+#include <Eigen/Dense>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <map>
+#include <memory>
+#include <cstddef>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include "../include/clt_core.h"
+#include "../include/ply.h"
+#include "../include/abd_solver.h"
+#include "../include/laminate_solver.h"
+#include "../include/input_parser.h"
+#include "../include/batch_runner.h"
+#include "../include/material_db.h"
+#include "../include/batch_screen.h"
+
+// One float per case of a group.
+using Lanes = Eigen::Array<float, kScreenLanes, 1>;
+
+// Solve cases [first, first + count) together, count <= kScreenLanes, and
+// return for each lane whether the float result can be trusted.
+void screen_group(const std::vector<ScreenCase>& cases, std::size_t first,
+                  int count, double tolerance, 
+                  std::vector<ScreenResult>& results);
+
+// Solve one case in double precision with the solver, growing the solver if
+// the case has more plies than its capacity.
+void solve_in_double(const ScreenCase& screen_case, laminate_solver& solver,
+                     ScreenResult& result);
+
+// Screen the cases and append their result rows to the output.
+void write_screen_results(const std::vector<ScreenCase>& cases,
+                          const std::vector<std::size_t>& line_numbers,
+                          double tolerance, std::ostream& output);
+
+using std::cout; using std::endl;
+using std::string; using std::string_view; using std::vector; using std::map;
+using Eigen::Matrix;
+
+vector<ScreenResult> screen_laminates(const vector<ScreenCase>& cases,
+                                      double tolerance) {
+    vector<ScreenResult> results(cases.size());
+    for (std::size_t first = 0; first < cases.size(); first += kScreenLanes) {
+        int count = std::min<std::size_t>(kScreenLanes, cases.size() - first);
+        screen_group(cases, first, count, tolerance, results);
+    }
+    laminate_solver solver(64);
+    for (std::size_t i = 0; i < cases.size(); i++) {
+        if (results[i].refined) {
+            solve_in_double(cases[i], solver, results[i]);
+        }
+    }
+    return results;
+}
+
+long long run_screen(const string& cases_filename,
+                     const string& material_data_filename,
+                     const string& output_filename, double tolerance) {
+    std::ifstream cases_file(cases_filename);
+    if (!cases_file.is_open()) {
+        cout << "Error: Cannot open file " << cases_filename << "." << endl;
+        return -1;
+    }
+    std::ofstream output_file(output_filename);
+    if (!output_file.is_open()) {
+        cout << "Error: Cannot open file " << output_filename << "." << endl;
+        return -1;
+    }
+    // The database stays mapped, and each label is read from it once.
+    map<string, Properties> material_data;
+    const std::unique_ptr<material_db> database =
+        open_material_data(material_data_filename, material_data);
+
+    long long screened = 0;
+    vector<ScreenCase> cases;
+    vector<std::size_t> line_numbers;
+    string line;
+    std::size_t line_number = 0;
+    while (getline(cases_file, line)) {
+        line_number++;
+        if (!is_batch_record(line)) {
+            continue;
+        }
+        BatchCase batch_case;
+        if (!parse_batch_case(line, database.get(), material_data, batch_case)
+            || batch_case.has_environment) {
+            cout << "Error: invalid screen case at line " << line_number 
+                 << "." << endl;
+            continue;
+        }
+        cases.push_back(ScreenCase{std::move(batch_case.plies), 
+                                   batch_case.load});
+        line_numbers.push_back(line_number);
+        if (cases.size() == kScreenChunkCases) {
+            write_screen_results(cases, line_numbers, tolerance, output_file);
+            screened += cases.size();
+            cases.clear();
+            line_numbers.clear();
+        }
+    }
+    write_screen_results(cases, line_numbers, tolerance, output_file);
+    return screened + cases.size();
+}
+
+void screen_group(const vector<ScreenCase>& cases, std::size_t first,
+                  int count, double tolerance, vector<ScreenResult>& results) {
+    std::size_t max_plies = 0;
+    for (int lane = 0; lane < count; lane++) {
+        max_plies = std::max(max_plies, cases[first + lane].plies.size());
+    }
+
+    // Lanes past count, and plies past the end of a shorter case, are padded
+    // with zero-thickness plies that contribute nothing.
+    Lanes height = Lanes::Zero();
+    for (int lane = 0; lane < count; lane++) {
+        for (const auto& p : cases[first + lane].plies) {
+            height(lane) += p.thickness;
+        }
+    }
+
+    // Unique entries of A, B and D in QbarEntry order.
+    Lanes A[6], B[6], D[6];
+    for (int j = 0; j < 6; j++) {
+        A[j].setZero();
+        B[j].setZero();
+        D[j].setZero();
+    }
+    Lanes bottom = -height / 2;
+    // Largest ratio of invariant magnitude to diagonal Qbar entry: the
+    // float invariant form loses this factor of precision to cancellation.
+    Lanes cancellation = Lanes::Ones();
+    for (std::size_t k = 0; k < max_plies; k++) {
+        Lanes E1 = Lanes::Ones(), E2 = Lanes::Ones(), nu12 = Lanes::Zero(),
+              G12 = Lanes::Ones(), theta = Lanes::Zero(), t = Lanes::Zero();
+        for (int lane = 0; lane < count; lane++) {
+            const auto& plies = cases[first + lane].plies;
+            if (k < plies.size()) {
+                E1(lane) = plies[k].properties.E1;
+                E2(lane) = plies[k].properties.E2;
+                nu12(lane) = plies[k].properties.nu12;
+                G12(lane) = plies[k].properties.G12;
+                theta(lane) = plies[k].theta;
+                t(lane) = plies[k].thickness;
+            }
+        }
+        // build_Q and build_invariants, lane-wise.
+        Lanes denominator = 1 - E2 / E1 * nu12.square();
+        Lanes Q11 = E1 / denominator;
+        Lanes Q22 = E2 / denominator;
+        Lanes Q12 = nu12 * E2 / denominator;
+        Lanes U1 = (3*Q11 + 3*Q22 + 2*Q12 + 4*G12) / 8;
+        Lanes U2 = (Q11 - Q22) / 2;
+        Lanes U3 = (Q11 + Q22 - 2*Q12 - 4*G12) / 8;
+        Lanes U4 = (Q11 + Q22 + 6*Q12 - 4*G12) / 8;
+        Lanes U5 = (Q11 + Q22 - 2*Q12 + 4*G12) / 8;
+
+        Lanes double_angle = theta * float(2 * M_PI/180);
+        Lanes c2 = double_angle.cos();
+        Lanes s2 = double_angle.sin();
+        Lanes c4 = c2.square() - s2.square();
+        Lanes s4 = 2 * s2 * c2;
+        Lanes qbar[6];
+        qbar[kQ11] = U1 + U2*c2 + U3*c4;
+        qbar[kQ12] = U4 - U3*c4;
+        qbar[kQ16] = U2/2*s2 + U3*s4;
+        qbar[kQ22] = U1 - U2*c2 + U3*c4;
+        qbar[kQ26] = U2/2*s2 - U3*s4;
+        qbar[kQ66] = U5 - U3*c4;
+
+        Lanes magnitude = U1.abs() + U2.abs() + U3.abs() + U5.abs();
+        Lanes smallest = qbar[kQ11].min(qbar[kQ22]).min(qbar[kQ66]);
+        cancellation = cancellation.max(magnitude / smallest);
+
+        Lanes top = bottom + t;
+        Lanes w1 = t * (top + bottom) / 2;
+        Lanes w2 = t * (top.square() + top * bottom + bottom.square()) / 3;
+        for (int j = 0; j < 6; j++) {
+            A[j] += qbar[j] * t;
+            B[j] += qbar[j] * w1;
+            D[j] += qbar[j] * w2;
+        }
+        bottom = top;
+    }
+
+    // Full symmetric stiffness matrix, K[i][j] for the load order (N, M).
+    const int unique_index[3][3] = {{kQ11, kQ12, kQ16}, 
+                                    {kQ12, kQ22, kQ26}, 
+                                    {kQ16, kQ26, kQ66}};
+    Lanes K[6][6];
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            K[i][j] = A[unique_index[i][j]];
+            K[i][j + 3] = B[unique_index[i][j]];
+            K[i + 3][j] = B[unique_index[i][j]];
+            K[i + 3][j + 3] = D[unique_index[i][j]];
+        }
+    }
+    // Padding lanes get an identity matrix.
+    for (int lane = count; lane < kScreenLanes; lane++) {
+        for (int i = 0; i < 6; i++) {
+            for (int j = 0; j < 6; j++) {
+                K[i][j](lane) = i == j ? 1.f : 0.f;
+            }
+        }
+    }
+
+    // Equilibrate to a unit diagonal: K' = S K S, x = S x', N' = S N.
+    Lanes scale[6];
+    for (int i = 0; i < 6; i++) {
+        scale[i] = K[i][i].rsqrt();
+    }
+    for (int i = 0; i < 6; i++) {
+        for (int j = 0; j < 6; j++) {
+            K[i][j] *= scale[i] * scale[j];
+        }
+    }
+
+    // LDLT without pivoting, lane-wise. L is stored in the lower triangle 
+    // of K and the pivots in d.
+    Lanes d[6];
+    for (int j = 0; j < 6; j++) {
+        d[j] = K[j][j];
+        for (int k = 0; k < j; k++) {
+            d[j] -= K[j][k].square() * d[k];
+        }
+        for (int i = j + 1; i < 6; i++) {
+            Lanes sum = K[i][j];
+            for (int k = 0; k < j; k++) {
+                sum -= K[i][k] * K[j][k] * d[k];
+            }
+            K[i][j] = sum / d[j];
+        }
+    }
+    Lanes min_pivot = d[0];
+    for (int j = 1; j < 6; j++) {
+        min_pivot = min_pivot.min(d[j]);
+    }
+
+    // Solve K' y = x in place, x being a scaled right-hand side.
+    auto solve_scaled = [&](Lanes (&x)[6]) {
+        for (int i = 0; i < 6; i++) {  // L y = N'
+            for (int k = 0; k < i; k++) {
+                x[i] -= K[i][k] * x[k];
+            }
+        }
+        for (int i = 0; i < 6; i++) {  // D z = y
+            x[i] /= d[i];
+        }
+        for (int i = 5; i >= 0; i--) {  // L^T x' = z
+            for (int k = i + 1; k < 6; k++) {
+                x[i] -= K[k][i] * x[k];
+            }
+        }
+    };
+    Lanes x[6];
+    for (int i = 0; i < 6; i++) {
+        for (int lane = 0; lane < kScreenLanes; lane++) {
+            x[i](lane) = lane < count ? cases[first + lane].load(i) : 0.f;
+        }
+        x[i] *= scale[i];
+    }
+    solve_scaled(x);
+
+    // Column j of the compliance is S K'^-1 S e_j.
+    Lanes compliance[6][6];
+    for (int j = 0; j < 6; j++) {
+        Lanes column[6];
+        for (int i = 0; i < 6; i++) {
+            column[i] = i == j ? scale[j] : Lanes::Zero();
+        }
+        solve_scaled(column);
+        for (int i = 0; i < 6; i++) {
+            compliance[i][j] = column[i] * scale[i];
+        }
+    }
+
+    // The relative error of the float solution grows like epsilon times the
+    // assembly cancellation over the smallest pivot of the equilibrated 
+    // matrix. A non-positive pivot fails the comparison as well.
+    const float epsilon = std::numeric_limits<float>::epsilon();
+    for (int lane = 0; lane < count; lane++) {
+        ScreenResult& result = results[first + lane];
+        bool finite = true;
+        for (int i = 0; i < 6; i++) {
+            result.response(i) = x[i](lane) * scale[i](lane);
+            finite = finite && std::isfinite(result.response(i));
+        }
+        result.refined = !finite 
+            || !(min_pivot(lane) * tolerance > epsilon * cancellation(lane));
+
+        ABDCompliance abd_compliance;
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                abd_compliance.a(i, j) = compliance[i][j](lane);
+                abd_compliance.b(i, j) = compliance[i][j + 3](lane);
+                abd_compliance.d(i, j) = compliance[i + 3][j + 3](lane);
+            }
+        }
+        result.constants = engineering_constants(abd_compliance, height(lane));
+    }
+}
+
+void solve_in_double(const ScreenCase& screen_case, laminate_solver& solver,
+                     ScreenResult& result) {
+    if (screen_case.plies.size() > solver.capacity_) {
+        solver = laminate_solver(2 * screen_case.plies.size());
+    }
+    solver.set_plies(screen_case.plies);
+    solver.solve(screen_case.load);
+    result.response << solver.mid_strain_, solver.mid_curvature_;
+    result.constants = solver.engineering_constants_;
+}
+
+void write_screen_results(const vector<ScreenCase>& cases,
+                          const vector<std::size_t>& line_numbers,
+                          double tolerance, std::ostream& output) {
+    vector<ScreenResult> results = screen_laminates(cases, tolerance);
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const EngineeringConstants& constants = results[i].constants;
+        output << line_numbers[i] << ' ' << results[i].response.transpose()
+               << ' ' << constants.Ex << ' ' << constants.Ey << ' ' 
+               << constants.Gxy << ' ' << constants.nuxy << ' ' 
+               << results[i].refined << '\n';
+    }
+}
@@ -1,60 +1,96 @@
 //! Implementation of the input_parser.
 
 #include <iostream>
-#include <sstream>
 #include <fstream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
+#include <memory>
 #include <utility>
 #include <stack>
 #include <algorithm>
+#include <cmath>
 #include <Eigen/Dense>
 #include "../include/ply.h"
+#include "../include/layup.h"
 #include "../include/input_parser.h"
+#include "../include/tokenizer.h"
+#include "../include/laminate_code.h"
+#include "../include/material_db.h"
 
 
-//! The subscript of the laminate code. e.g. [0/45/45/90]8s4. 8 is the pre_count,
-//! s is the has_symmetry, and 4 is the post_count.
-struct SubscriptInfo {
-    int pre_count;
-    bool has_symmetry;
-    int post_count;
-};
-
-//! Read material_data file and return the format into a map.
+//! Read material_data file and return the format into a map. The first line
+//! names the columns: Label, E1, E2, nu12, G12, and optionally the other
+//! properties, in any order after the label. Returns an empty map if a column
+//! is unknown or one of E1, E2, nu12, G12 is missing, and the materials
+//! before the first corrupted line if there is one.
 std::map<std::string, Properties> 
     load_material_data(const std::string& filename);
 
+//! Read the material_data file into data as load_material_data does. Returns
+//! false, after printing the reason, if the file cannot be opened, the header
+//! is invalid or a line is corrupted; data then holds the lines before it.
+bool read_material_data(const std::string& filename,
+                        std::map<std::string, Properties>& data);
+
+//! Return the properties of the given material labels, read from either a
+//! text material_data file or a compiled material database.
+std::map<std::string, Properties> load_materials(
+    const std::string& filename, const std::vector<std::string>& labels);
+
+// Store value into the property named column. Returns false if there is no
+// property of that name.
+bool set_material_property(Properties& p, std::string_view column, 
+                           double value);
+
 //! Parse the laminate code and return a pair in which the first elemnt is the
 //! vector containing ply angles, and the second element is the SubscriptInfo
 //! of the given laminate. 
 std::pair<std::vector<double>, SubscriptInfo> 
-    laminate_code_parser(std::string laminate_code);
+    laminate_code_parser(std::string_view laminate_code);
 
 // Parse the trailing info of the laminate code and return the info into the
 // SubscriptInfo struct.
-SubscriptInfo subscript_parser(std::string subscript);
+SubscriptInfo subscript_parser(std::string_view subscript);
 
-//! Convert the laminate information into a vector of ply objects.
-std::vector<ply> build_laminate_vector(
+//! Convert the laminate information into a compressed layup, which holds one
+//! ply object for each angle inside the brackets of the laminate code. The
+//! layup has no plies, after the reason is printed, if a label is unknown, a
+//! thickness is not positive, or there is not one of each per angle.
+layup build_layup(
     const std::pair<std::vector<double>, SubscriptInfo>& layout_info,
     std::vector<std::string>& ply_materials,
     const std::vector<double>& ply_thickness, 
     const std::map<std::string, Properties>& material_map);
 
-//! Strip the left and right square bracket of a string.
-std::string strip_bracket(std::string input_str);
-
-//! Convert the string inside bracket into vector of doubles.
-std::vector<double> strs_to_vector(std::string code);
-
-//! Convert the string inside bracket into vector of strings. Used for the
-//! material data parsing.
-std::vector<std::string> mat_str_to_vector(std::string strings);
-
-using std::string;
-using std::cin; using std::cout; using std::endl;
+//! Read the numbers inside the brackets of a line, e.g. the ply thicknesses.
+std::vector<double> bracket_numbers(std::string_view line);
+
+// Returns false, after printing the reason, if a material label is not in
+// material_data or a ply thickness is not greater than 0.
+bool check_ply_entries(const std::vector<std::string>& ply_materials,
+                       const std::vector<double>& ply_thickness,
+                       const std::map<std::string, Properties>& material_data);
+
+// Build the plies of the laminate strings, from bottom to top, with 
+// make_ply(label, properties, theta, thickness), which returns a Ply. Returns
+// an empty vector, after printing the reason, if the input is invalid.
+template <typename Ply, typename MakePly>
+std::vector<Ply> build_ply_sequence(
+    std::vector<std::string>& input_strings,
+    const std::map<std::string, Properties>& material_data, MakePly make_ply);
+
+//! Build the plies of an extended laminate code by walking its AST. The
+//! material labels and thicknesses follow the written angles of the code, e.g.
+//! [(0/90)2/±45]s takes three of each, or a single one for every ply.
+template <typename Ply, typename MakePly>
+std::vector<Ply> expand_laminate_code(
+    std::vector<std::string>& input_strings,
+    const std::map<std::string, Properties>& material_data, MakePly make_ply);
+
+using std::string; using std::string_view;
+using std::cin; using std::endl;
 using std::vector; using std::map; using std::stack; using std::pair;
 
 vector<string> read_composite_input(const string& filename) {
@@ -75,40 +111,173 @@ vector<string> read_composite_input(const string& filename) {
 
 vector<ply> get_ply_vector(vector<string>& input_strings, 
     const string& material_data_filename) {
-        
-        map<string, Properties> material_data = 
-            load_material_data(material_data_filename);
-
-        pair<vector<double>, SubscriptInfo> layout_info =
-            laminate_code_parser(input_strings[0]);
-
-        string material_strings = strip_bracket(input_strings[1]);
-        vector<string> ply_materials = 
-            mat_str_to_vector(material_strings);
-        
-        string thickness_strings = strip_bracket(input_strings[2]);
-
-        vector<double> ply_thickness =
-            strs_to_vector(thickness_strings);
-            
-        vector<ply> laminate = build_laminate_vector(layout_info, 
-            ply_materials, ply_thickness, material_data);
-    
-    return laminate;
+    return get_ply_vector(input_strings, 
+        load_materials(material_data_filename, 
+                       bracket_labels(input_strings[1])));
+}
+
+vector<ply> get_ply_vector(vector<string>& input_strings,
+    const map<string, Properties>& material_data) {
+    return build_ply_sequence<ply>(input_strings, material_data, 
+        [](const string& label, const Properties& p, double theta, 
+           double thickness) {
+            return ply(label, p, theta, thickness);
+        });
+}
+
+vector<BasicLamina<double>> get_lamina_vector(vector<string>& input_strings,
+    const map<string, Properties>& material_data) {
+    return build_ply_sequence<BasicLamina<double>>(input_strings, 
+        material_data, 
+        [](const string&, const Properties& p, double theta, 
+           double thickness) {
+            return BasicLamina<double>{p, theta, thickness};
+        });
+}
+
+template <typename Ply, typename MakePly>
+vector<Ply> build_ply_sequence(vector<string>& input_strings,
+    const map<string, Properties>& material_data, MakePly make_ply) {
+    vector<string> ply_materials = bracket_labels(input_strings[1]);
+    if (!check_ply_entries(ply_materials, bracket_numbers(input_strings[2]),
+                           material_data)) {
+        return vector<Ply>();
     }
+    if (is_extended_code(input_strings[0])) {
+        return expand_laminate_code<Ply>(input_strings, material_data, 
+                                         make_ply);
+    }
+
+    pair<vector<double>, SubscriptInfo> layout_info =
+        laminate_code_parser(input_strings[0]);
+    vector<double> ply_thickness = bracket_numbers(input_strings[2]);
+    if (layout_info.first.empty() 
+        || ply_materials.size() != layout_info.first.size()
+        || ply_thickness.size() != layout_info.first.size()) {
+        parser_messages() << "Error: the laminate code needs one material "
+            "label and one ply thickness per angle." << endl;
+        return vector<Ply>();
+    }
+
+    // Each written angle is made once and copied into its repetitions, in
+    // the order of layup::expand.
+    const vector<double>& theta_vec = layout_info.first;
+    vector<Ply> base_plies;
+    base_plies.reserve(theta_vec.size());
+    for (std::size_t k = 0; k < theta_vec.size(); k++) {
+        base_plies.push_back(make_ply(ply_materials[k], 
+            material_data.at(ply_materials[k]), theta_vec[k], 
+            ply_thickness[k]));
+    }
+    const SubscriptInfo& subscript = layout_info.second;
+    std::size_t count = expanded_ply_count(subscript, base_plies.size());
+    vector<Ply> plies;
+    plies.reserve(count);
+    for (std::size_t i = 0; i < count; i++) {
+        plies.push_back(
+            base_plies[base_ply_index(subscript, base_plies.size(), i)]);
+    }
+    return plies;
+}
 
-Eigen::Matrix<double, 6, 1> get_load_vector(string& input_string) {
-    string load_string = strip_bracket(input_string);
-    vector<double> load_stl_vector = strs_to_vector(load_string);
-    Eigen::Matrix<double, 6, 1> load_vector(load_stl_vector.data());
-    return load_vector;
+std::unique_ptr<material_db> open_material_data(const string& filename,
+    map<string, Properties>& material_data) {
+    if (!is_material_db(filename)) {
+        material_data = load_material_data(filename);
+        return nullptr;
+    }
+    auto database = std::make_unique<material_db>(filename);
+    if (!database->is_open()) {
+        return nullptr;
+    }
+    return database;
+}
 
+void find_materials(const material_db& database, const vector<string>& labels,
+                    map<string, Properties>& material_data) {
+    for (const string& label : labels) {
+        Properties p;
+        if (material_data.count(label) == 0 && database.find(label, p)) {
+            material_data.insert({label, p});
+        }
+    }
+}
+
+layup get_layup(vector<string>& input_strings, 
+    const string& material_data_filename) {
+    vector<string> ply_materials = bracket_labels(input_strings[1]);
+    map<string, Properties> material_data = 
+        load_materials(material_data_filename, ply_materials);
+    if (is_extended_code(input_strings[0])) {
+        // The extended grammar has no single base sequence; its plies are
+        // kept expanded under a subscript that repeats them once.
+        return layup(get_ply_vector(input_strings, material_data), 
+                     SubscriptInfo{1, false, 0});
+    }
+    return build_layup(laminate_code_parser(input_strings[0]), ply_materials,
+                       bracket_numbers(input_strings[2]), material_data);
+}
+
+template <typename Scalar>
+Eigen::Matrix<Scalar, 6, 1> get_load_vector(string& input_string) {
+    // The numbers are converted in the precision of Scalar, so a long double
+    // load is not rounded to double first.
+    vector<Scalar> load_stl_vector;
+    if (!parse_numbers(bracket_contents(input_string), load_stl_vector)) {
+        parser_messages() << "Error: invalid number in " << input_string 
+                          << "." << endl;
+    }
+    if (load_stl_vector.size() != 6) {
+        parser_messages() << "Error: a load vector needs 6 numbers." << endl;
+        return Eigen::Matrix<Scalar, 6, 1>::Zero();
+    }
+    return Eigen::Matrix<Scalar, 6, 1>(load_stl_vector.data());
+
+}
+
+template Eigen::Matrix<float, 6, 1> get_load_vector<float>(string&);
+template Eigen::Matrix<double, 6, 1> get_load_vector<double>(string&);
+template Eigen::Matrix<long double, 6, 1> get_load_vector<long double>(string&);
+
+Eigen::Vector2d get_environment(string& environment_string) {
+    vector<double> values = bracket_numbers(environment_string);
+    if (values.size() != 2) {
+        parser_messages() << "Error: the environment needs [delta_T, "
+                             "delta_C]." << endl;
+        return Eigen::Vector2d::Zero();
+    }
+    return Eigen::Vector2d(values[0], values[1]);
+}
+
+Eigen::Matrix<double, 6, Eigen::Dynamic> get_load_cases(
+    const string& filename) {
+    vector<string> load_strings = read_composite_input(filename);
+    Eigen::Matrix<double, 6, Eigen::Dynamic> load_cases(6, load_strings.size());
+    for (vector<string>::size_type i = 0; i < load_strings.size(); i++) {
+        load_cases.col(i) = get_load_vector(load_strings[i]);
+    }
+    return load_cases;
+}
+
+bool compile_material_data(const string& material_data_filename,
+                           const string& database_filename) {
+    map<string, Properties> material_data;
+    if (!read_material_data(material_data_filename, material_data)) {
+        parser_messages() << "Error: " << database_filename 
+                          << " is not written." << endl;
+        return false;
+    }
+    if (material_data.empty()) {
+        parser_messages() << "Error: no material read from " 
+                          << material_data_filename << "." << endl;
+        return false;
+    }
+    return write_material_db(material_data, database_filename);
 }
 
 double get_minimum_ply_thickness(string& thickness_strings_with_brackets) {
-    string thickness_strings = strip_bracket(thickness_strings_with_brackets);
-    vector<double> ply_thickness =
-        strs_to_vector(thickness_strings);
+    vector<double> ply_thickness = 
+        bracket_numbers(thickness_strings_with_brackets);
     auto min_it = std::min_element(ply_thickness.begin(), 
                                     ply_thickness.end());
     
@@ -119,157 +288,263 @@ double get_minimum_ply_thickness(string& thickness_strings_with_brackets) {
 
 map<string, Properties> load_material_data(const string& filename) {
     map<string, Properties> data;
+    read_material_data(filename, data);
+    return data;
+}
+
+bool read_material_data(const string& filename, 
+                        map<string, Properties>& data) {
     string line;
     std::ifstream input_file(filename);
     if (input_file.is_open()) {
-        string material_name;
-        Properties p;
-        input_file.ignore(500, '\n');  // Ignore the first line
-        while (!input_file.eof()) {
-            input_file >> material_name >> p.E1 >> p.E2 >> p.nu12 >> p.G12;
-            if (!input_file) {
-                cout << "Error: file corrupted. Lines After " 
-                    "corrupted line are not read."<< endl;
-                break;
+        // The column names, without the leading Label column.
+        vector<string> columns;
+        getline(input_file, line);
+        tokenizer header(line, kLabelDelimiters);
+        string_view column;
+        header.next(column);
+        while (header.next(column)) {
+            columns.emplace_back(column);
+        }
+        Properties unused;
+        for (const string& name : columns) {
+            if (!set_material_property(unused, name, 0.)) {
+                parser_messages() << "Error: unknown material column " 
+                                  << name << "." << endl;
+                return false;
             }
-            data.insert({material_name, p});
+        }
+        // The other properties default to 0, these have no default.
+        for (const char* required : {"E1", "E2", "nu12", "G12"}) {
+            if (std::find(columns.begin(), columns.end(), required) 
+                == columns.end()) {
+                parser_messages() << "Error: material column " << required 
+                                  << " is missing." << endl;
+                return false;
+            }
+        }
+
+        while (getline(input_file, line)) {
+            tokenizer row(line, kLabelDelimiters);
+            string_view material_name;
+            if (!row.next(material_name)) {
+                continue;  // Blank line
+            }
+            Properties p;
+            bool complete = true;
+            for (const string& name : columns) {
+                string_view token;
+                double value;
+                complete = complete && row.next(token) 
+                    && parse_number(token, value);
+                if (complete) {
+                    set_material_property(p, name, value);
+                }
+            }
+            if (!complete) {
+                parser_messages() << "Error: file corrupted. Lines After " 
+                                     "corrupted line are not read."<< endl;
+                return false;
+            }
+            data.insert({string(material_name), p});
         }
     } else {
-        cout << "Error: Cannot open file." ;
+        parser_messages() << "Error: Cannot open file." ;
+        return false;
+    }
+    return true;
+}
+
+map<string, Properties> load_materials(const string& filename,
+                                      const vector<string>& labels) {
+    map<string, Properties> data;
+    std::unique_ptr<material_db> database = open_material_data(filename, data);
+    if (database != nullptr) {
+        find_materials(*database, labels, data);
     }
     return data;
 }
 
-string strip_bracket(string input_str) {
-    std::size_t left_bracket_pos = input_str.find("[");
-    std::size_t right_bracket_pos = input_str.find("]");
-    return input_str.substr(left_bracket_pos+1, 
-        right_bracket_pos-left_bracket_pos-1);
+vector<string> bracket_labels(string_view line) {
+    vector<string> labels;
+    tokenizer tokens(bracket_contents(line), kLabelDelimiters);
+    string_view label;
+    while (tokens.next(label)) {
+        labels.emplace_back(label);
+    }
+    return labels;
+}
 
+bool set_material_property(Properties& p, string_view column, 
+                           double value) {
+    if (column == "E1") {
+        p.E1 = value;
+    } else if (column == "E2") {
+        p.E2 = value;
+    } else if (column == "nu12") {
+        p.nu12 = value;
+    } else if (column == "G12") {
+        p.G12 = value;
+    } else if (column == "G13") {
+        p.G13 = value;
+    } else if (column == "G23") {
+        p.G23 = value;
+    } else if (column == "alpha1") {
+        p.alpha1 = value;
+    } else if (column == "alpha2") {
+        p.alpha2 = value;
+    } else if (column == "beta1") {
+        p.beta1 = value;
+    } else if (column == "beta2") {
+        p.beta2 = value;
+    } else {
+        return false;
+    }
+    return true;
 }
 
-pair<vector<double>, SubscriptInfo> laminate_code_parser(string laminate_code) {
-    std::size_t left_bracket_pos = laminate_code.find("[");
-    std::size_t right_bracket_pos = laminate_code.find("]");
+bool check_ply_entries(const vector<string>& ply_materials,
+                       const vector<double>& ply_thickness,
+                       const map<string, Properties>& material_data) {
+    for (const string& label : ply_materials) {
+        if (material_data.count(label) == 0) {
+            parser_messages() << "Error: unknown material " << label << "."
+                              << endl;
+            return false;
+        }
+    }
+    for (double thickness : ply_thickness) {
+        if (!(thickness > 0) || !std::isfinite(thickness)) {
+            parser_messages() << "Error: ply thicknesses must be greater "
+                                 "than 0." << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+vector<double> bracket_numbers(string_view line) {
+    vector<double> values;
+    if (!parse_numbers(bracket_contents(line), values)) {
+        parser_messages() << "Error: invalid number in " << line << "." << endl;
+    }
+    return values;
+}
+
+pair<vector<double>, SubscriptInfo> laminate_code_parser(
+    string_view laminate_code) {
+    std::size_t left_bracket_pos = laminate_code.find('[');
+    std::size_t right_bracket_pos = laminate_code.find(']');
     pair<vector<double>, SubscriptInfo> result;
-    if (left_bracket_pos == string::npos || right_bracket_pos == string::npos
+    if (left_bracket_pos == string_view::npos 
+        || right_bracket_pos == string_view::npos
         || left_bracket_pos > right_bracket_pos) {
-            cout << "Invalid laminate code input." << endl;
+            parser_messages() << "Invalid laminate code input." << endl;
         return result;
     }
-    string theta_string = laminate_code.substr(left_bracket_pos+1, 
-        right_bracket_pos-left_bracket_pos-1);
-    string subscript_string = laminate_code.substr(right_bracket_pos+1, 
-        laminate_code.size()-right_bracket_pos-1);
-    result.first = strs_to_vector(theta_string);
-    result.second = subscript_parser(subscript_string);
+    result.first = bracket_numbers(laminate_code);
+    for (double theta : result.first) {
+        if (!std::isfinite(theta)) {
+            parser_messages() << "Error: ply angles must be finite." << endl;
+            result.first.clear();
+            break;
+        }
+    }
+    result.second = subscript_parser(after_bracket(laminate_code));
     return result;
 }
 
-vector<ply> build_laminate_vector(
+layup build_layup(
     const pair<vector<double>, SubscriptInfo>& layout_info,
     vector<string>& ply_materials,
     const vector<double>& ply_thickness, 
     const std::map<string, Properties>& material_map) {
-        
-        vector<double> theta_vec = layout_info.first;
-        SubscriptInfo info = layout_info.second;
-
-        vector<ply> laminate_vec;
-        stack<ply> ply_stack;
-        
-        // It's not optimized in that we don't need the stack operation if 
-        // we don't have the symmetry subscript, but this arrangement 
-        // makes the code less redundant.
-        for (int i = 1; i <= info.pre_count; i++) {
-            auto theta_it = theta_vec.begin();
-            auto mat_it = ply_materials.begin();
-            auto t_it = ply_thickness.begin();
-            for (; theta_it != theta_vec.end(); theta_it++, mat_it++, t_it++) {
-                ply local_ply(*mat_it, material_map.at(*mat_it), 
-                    *theta_it, *t_it);
-                laminate_vec.push_back(local_ply);
-                ply_stack.push(local_ply); // for symmetric condition
-            }
-        }
-
-        if (info.has_symmetry) {
-            while (!ply_stack.empty()) {
-                laminate_vec.push_back(ply_stack.top());
-                ply_stack.pop();
-            }
-        }
-
-        if (info.post_count > 1) {
-            vector<ply> laminate_copy(laminate_vec);
-            for (int i = 2; i <= info.post_count; i++) {
-                for (auto it = laminate_copy.begin(); 
-                    it != laminate_copy.end(); it++) {
-                    laminate_vec.push_back(*it);
-                }
-
-            }
-        }
-
-    
-    return laminate_vec;
-
-}
-
-std::vector<double> strs_to_vector(string theta_string) {
-    std::replace(theta_string.begin(), theta_string.end(), '/', ' ');
-    std::replace(theta_string.begin(), theta_string.end(), ',', ' ');
-    std::istringstream theta_stream(theta_string);
-    std::vector<double> theta_vec;
-    double theta;
-    while (theta_stream >> theta) {
-        theta_vec.push_back(theta);
+    const vector<double>& theta_vec = layout_info.first;
+    vector<ply> base_plies;
+    if (!check_ply_entries(ply_materials, ply_thickness, material_map)) {
+        return layup(base_plies, layout_info.second);
     }
-
-    return theta_vec;
-}
-
-std::vector<string> mat_str_to_vector(string strings) {
-    std::replace(strings.begin(), strings.end(), ',', ' ');
-    std::istringstream stream(strings);
-    std::vector<string> vec;
-    string single_string;
-    while (stream >> single_string) {
-        vec.push_back(single_string);
+    if (theta_vec.empty() || ply_materials.size() != theta_vec.size()
+        || ply_thickness.size() != theta_vec.size()) {
+        parser_messages() << "Error: the laminate code needs one material "
+            "label and one ply thickness per angle." << endl;
+        return layup(base_plies, layout_info.second);
+    }
+    base_plies.reserve(theta_vec.size());
+    for (std::size_t k = 0; k < theta_vec.size(); k++) {
+        base_plies.push_back(ply(ply_materials[k], 
+            material_map.at(ply_materials[k]), theta_vec[k], 
+            ply_thickness[k]));
     }
-    return vec;
+    return layup(base_plies, layout_info.second);
 }
 
-SubscriptInfo subscript_parser(string subscript) {
+SubscriptInfo subscript_parser(string_view subscript) {
+    // Whitespace (e.g. a carriage return) after the code is ignored.
+    std::size_t end = subscript.find_last_not_of(" \t\r");
+    subscript = end == string_view::npos ? string_view() 
+                                         : subscript.substr(0, end + 1);
     SubscriptInfo info;
-    std::size_t s_pos = subscript.find("s");
-    if (s_pos != string::npos) {  // subscript contains an 's'
+    std::size_t s_pos = subscript.find('s');
+    if (s_pos != string_view::npos) {  // subscript contains an 's'
         info.has_symmetry = true;
 
-        if (s_pos != 0) {  // subscript not at the beginning
-            string pre_repetition_string = subscript.substr(0, s_pos);
-            if (std::stoi(pre_repetition_string) > 0) {
-                info.pre_count = std::stoi(pre_repetition_string);
-            } else {
-                info.pre_count = 1;
-            }
-        } else {
+        // A missing or non-positive count before the 's' means 1.
+        if (!parse_number(subscript.substr(0, s_pos), info.pre_count) 
+            || info.pre_count <= 0) {
             info.pre_count = 1;
         }
 
-        if (s_pos != subscript.size() - 1) {  // subscript not at the end
-            string post_repetition_string = 
-                subscript.substr(s_pos+1, subscript.size());
-            info.post_count = std::stoi(post_repetition_string);
-        } else {
+        if (!parse_number(subscript.substr(s_pos + 1), info.post_count)) {
             info.post_count = 1;
         }
 
     } else {
-        string pre_repetition_string = subscript.substr(0, subscript.size());
-        info.pre_count = std::stoi(pre_repetition_string);
+        if (!parse_number(subscript, info.pre_count) || info.pre_count <= 0) {
+            info.pre_count = 1;
+        }
         info.has_symmetry = false;
         info.post_count = 0;
     }
     return info;
-}
\ No newline at end of file
+}
+
+template <typename Ply, typename MakePly>
+vector<Ply> expand_laminate_code(vector<string>& input_strings,
+    const map<string, Properties>& material_data, MakePly make_ply) {
+    vector<Ply> plies;
+    laminate_code code;
+    if (!parse_laminate_code(input_strings[0], code)) {
+        return plies;
+    }
+
+    vector<string> ply_materials = bracket_labels(input_strings[1]);
+    vector<double> ply_thickness = bracket_numbers(input_strings[2]);
+
+    auto entry_count_valid = [&](std::size_t count) {
+        return count == 1 || count == std::size_t(code.leaf_count_);
+    };
+    if (!entry_count_valid(ply_materials.size()) 
+        || !entry_count_valid(ply_thickness.size())) {
+        parser_messages() << "Error: the laminate code needs " 
+                          << code.leaf_count_ 
+                          << " (or 1) material labels and ply thicknesses." 
+                          << endl;
+        return plies;
+    }
+
+    if (code.ply_count() > plies.max_size()) {
+        parser_messages() << "Error: the laminate code has too many plies."
+                          << endl;
+        return plies;
+    }
+    plies.reserve(code.ply_count());
+    code.for_each_ply([&](double angle, int leaf) {
+        const string& material = 
+            ply_materials[ply_materials.size() == 1 ? 0 : leaf];
+        double thickness = ply_thickness[ply_thickness.size() == 1 ? 0 : leaf];
+        plies.push_back(
+            make_ply(material, material_data.at(material), angle, thickness));
+    });
+    return plies;
+}
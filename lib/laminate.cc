@@ -4,89 +4,350 @@
 #include <array>
 #include <string>
 #include <cmath>
+#include <algorithm>
 
 #include "../include/input_parser.h"
 #include "../include/ply.h"
+#include "../include/layup.h"
+#include "../include/abd_solver.h"
+#include "../include/ply_table.h"
+#include "../include/abd_index.h"
 #include "../include/laminate.h"
+#include "../include/profile_view.h"
+#include "../include/parallel_ranges.h"
 
 using std::cin; using std::cout; using std::endl;
 using std::string;
 using std::vector;
 using Eigen::Matrix; using Eigen::Matrix3d; using Eigen::Vector3d;
+using Eigen::Matrix2d;
 
 // Get the mid-plane strain of the laminate.
 void solve_mid_strain(laminate& lam, Matrix<double, 6, 1>& load_vector);
 
-// Get the stresses and strains for each sampling point of the laminate.
-void solve_stress_strain_profile(laminate& lam, double pt_spacing);
+// Get the stresses and strains at the bottom and top of each ply.
+void solve_profile_segments(const laminate& lam);
 
-// Construct laminate from a vector of ply, the input load, and the spacing
-// between sampling points.
+// Copy the moments of a block (A_, B_, D_, the shear moments and the 
+// expansion resultants) into the laminate.
+void set_laminate_block(laminate& lam, const BlockStiffness& block);
+
+// A block with all moments zero.
+BlockStiffness empty_block();
+
+// Add sign times the moments of the ply p between the coordinates bottom and
+// top to the block.
+void add_ply_moments(BlockStiffness& block, const ply& p, double bottom, 
+                     double top, double sign);
+
+// Leave the laminate without plies, stiffness or response. A zero-thickness
+// ply has no stiffness and no profile, so the laminate is left empty instead
+// of producing NaN responses.
+void clear_laminate(laminate& lam);
+
+// Returns false, after printing the reason, if a ply is not thicker than 0.
+bool check_ply_thickness(const vector<ply>& ply_vector);
+
+// The block of a single ply about its own mid-plane.
+BlockStiffness single_ply_block(const ply& p);
+
+// Build the block tree of the laminate if it is not built yet.
+void build_block_tree(laminate& lam);
+
+// Recompute the leaf of the i-th ply and the nodes above it, then update 
+// A_, B_, D_ and the response from the root.
+void update_ply_block(laminate& lam, std::size_t i);
+
+// Replace the i-th ply and update A_, B_, D_ and the response.
+void replace_ply(laminate& lam, std::size_t i, const ply& new_ply);
+
+// Construct laminate from a vector of ply and the input load.
 laminate::laminate(vector<ply>& ply_vector, Matrix<double, 6, 1>& load_vector,
-                    double pt_spacing): 
-        ply_vector_(ply_vector), load_vector_(load_vector) {
-    height_ = 0.;
-    for (auto it = ply_vector_.begin(); it != ply_vector_.end(); it++) {
-        height_ += it->thickness_;
+                   double delta_T, double delta_C): 
+        ply_vector_(ply_vector), load_vector_(load_vector), 
+        delta_T_(delta_T), delta_C_(delta_C) {
+    profile_segments_stale_ = false;
+    if (!check_ply_thickness(ply_vector_)) {
+        clear_laminate(*this);
+        return;
     }
-    
-    A_ = Matrix3d::Zero();
-    B_ = Matrix3d::Zero();
-    D_ = Matrix3d::Zero();
-    double bottom_coordinate = -height_/2;
-    for (auto it = ply_vector_.begin(); it != ply_vector_.end(); it++) {
-        double top_coordinate = bottom_coordinate + it->thickness_;
-        A_ = A_ + it->Qbar_ * (top_coordinate - bottom_coordinate);
-        B_ = B_ + 1./2 * it->Qbar_ 
-            * (pow(top_coordinate, 2) - pow(bottom_coordinate, 2));
-        D_ = D_ + 1./3 * it->Qbar_
-            * (pow(top_coordinate, 3) - pow(bottom_coordinate, 3));
-        
-        bottom_coordinate = top_coordinate;
+    set_laminate_block(*this, ply_block_stiffness(ply_vector_));
+    solve_mid_strain(*this, load_vector_);
+    solve_profile_segments(*this);
+
+}
+
+laminate::laminate(const layup& plies, Matrix<double, 6, 1>& load_vector,
+                   double delta_T, double delta_C): 
+        ply_vector_(plies.expand()), load_vector_(load_vector), 
+        delta_T_(delta_T), delta_C_(delta_C) {
+    profile_segments_stale_ = false;
+    if (!check_ply_thickness(plies.base_plies_)) {
+        clear_laminate(*this);
+        return;
     }
+    set_laminate_block(*this, plies.stiffness());
     solve_mid_strain(*this, load_vector_);
-    solve_stress_strain_profile(*this, pt_spacing);
+    solve_profile_segments(*this);
+}
 
+void clear_laminate(laminate& lam) {
+    lam.ply_vector_.clear();
+    set_laminate_block(lam, empty_block());
+    lam.compliance_.a.setZero();
+    lam.compliance_.b.setZero();
+    lam.compliance_.d.setZero();
+    lam.compliance_.is_symmetric = true;
+    lam.compliance_.is_balanced = true;
+    lam.compliance_.path = SolvePath::decoupled;
+    lam.engineering_constants_ = EngineeringConstants();
+    lam.As_.setZero();
+    lam.mid_strain_.setZero();
+    lam.mid_curvature_.setZero();
 }
 
-void solve_mid_strain(laminate& lam, Matrix<double, 6, 1>& load_vector) {
-    Matrix<double, 6, 6> stiffness = Matrix<double, 6, 6>::Zero();
-    stiffness.block<3, 3>(0, 0) = lam.A_;
-    stiffness.block<3, 3>(0, 3) = lam.B_;
-    stiffness.block<3, 3>(3, 0) = lam.B_;
-    stiffness.block<3, 3>(3, 3) = lam.D_;
-    Matrix<double, 6, 1> strain_vector = 
-        stiffness.colPivHouseholderQr().solve(load_vector);
-    lam.mid_strain_ = strain_vector.head<3>();
-    lam.mid_curvature_ = strain_vector.tail<3>();
-}
-
-void solve_stress_strain_profile(laminate& lam, double pt_spacing) {
-       
-    lam.profile_pt_.push_back(-lam.height_/2);
-    lam.strains_.push_back(
-        lam.mid_strain_ + lam.profile_pt_.back() * lam.mid_curvature_);
-    vector<ply>::size_type current_layer = 0;  
-    lam.stresses_.push_back(
-        lam.ply_vector_[current_layer].Qbar_ * lam.strains_.back());
-
-    double current_bottom_pt = -lam.height_/2;
-    double current_top_pt = current_bottom_pt
-                          + lam.ply_vector_[current_layer].thickness_;
-    while (lam.profile_pt_.back() <= lam.height_/2) {
-        double next_profile_pt = lam.profile_pt_.back() + pt_spacing;
-        if (next_profile_pt > current_top_pt) {
-            current_bottom_pt = current_top_pt;
-            current_layer++;
-            current_top_pt = current_bottom_pt
-                           + lam.ply_vector_[current_layer].thickness_;
+bool check_ply_thickness(const vector<ply>& ply_vector) {
+    for (vector<ply>::size_type i = 0; i < ply_vector.size(); i++) {
+        if (!(ply_vector[i].thickness_ > 0) 
+            || !std::isfinite(ply_vector[i].thickness_)) {
+            cout << "Error: ply " << i + 1 << " has a thickness of " 
+                 << ply_vector[i].thickness_ << "; plies must be thicker "
+                 "than 0." << endl;
+            return false;
         }
-        lam.profile_pt_.push_back(lam.profile_pt_.back() + pt_spacing);
-        lam.strains_.push_back(
-            lam.mid_strain_ + lam.profile_pt_.back() * lam.mid_curvature_);
-        lam.stresses_.push_back(
-            lam.ply_vector_[current_layer].Qbar_ * lam.strains_.back());
     }
+    return true;
+}
+
+void solve_mid_strain(laminate& lam, Matrix<double, 6, 1>& load_vector) {
+    lam.compliance_ = invert_abd(lam.A_, lam.B_, lam.D_);
+    lam.engineering_constants_ = 
+        engineering_constants(lam.compliance_, lam.height_);
+    lam.As_ = transverse_shear_stiffness(lam.S0_, lam.S2_, lam.height_);
+    // The environment enters as equivalent forces and moments.
+    Matrix<double, 6, 1> total_load = load_vector + lam.environmental_load();
+    lam.mid_strain_ = lam.compliance_.a * total_load.head<3>()
+                    + lam.compliance_.b * total_load.tail<3>();
+    lam.mid_curvature_ = lam.compliance_.b.transpose() * total_load.head<3>()
+                       + lam.compliance_.d * total_load.tail<3>();
+}
+
+Matrix<double, 6, 1> laminate::environmental_load() const {
+    Matrix<double, 6, 1> load;
+    load << delta_T_ * NT_ + delta_C_ * NH_, 
+            delta_T_ * MT_ + delta_C_ * MH_;
+    return load;
+}
+
+const vector<PlySegment>& laminate::profile_segments() const {
+    if (profile_segments_stale_) {
+        solve_profile_segments(*this);
+    }
+    return profile_segments_;
+}
+
+Vector3d laminate::free_strain(std::size_t i) const {
+    return delta_T_ * ply_vector_[i].alpha_ + delta_C_ * ply_vector_[i].beta_;
+}
+
+Matrix<double, 6, Eigen::Dynamic> laminate::solve_load_cases(
+    const Matrix<double, 6, Eigen::Dynamic>& load_cases) const {
+    return compliance_matrix(compliance_) * load_cases;
+}
+
+Matrix<double, Eigen::Dynamic, 6> laminate::stress_basis() const {
+    Matrix<double, 6, 6> compliance = compliance_matrix(compliance_);
+    Matrix<double, Eigen::Dynamic, 6> basis(6 * ply_vector_.size(), 6);
+    double bottom_coordinate = -height_/2;
+    for (vector<ply>::size_type i = 0; i < ply_vector_.size(); i++) {
+        double top_coordinate = bottom_coordinate + ply_vector_[i].thickness_;
+        // Strains per unit load at z are the mid-plane rows of the compliance
+        // plus z times the curvature rows.
+        basis.block<3, 6>(6*i, 0) = ply_vector_[i].Qbar_ 
+            * (compliance.topRows<3>() 
+               + bottom_coordinate * compliance.bottomRows<3>());
+        basis.block<3, 6>(6*i + 3, 0) = ply_vector_[i].Qbar_ 
+            * (compliance.topRows<3>() 
+               + top_coordinate * compliance.bottomRows<3>());
+        bottom_coordinate = top_coordinate;
+    }
+    return basis;
+}
+
+Matrix<double, Eigen::Dynamic, 1> laminate::restrained_free_stress() const {
+    Matrix<double, Eigen::Dynamic, 1> stress(6 * ply_vector_.size());
+    for (vector<ply>::size_type i = 0; i < ply_vector_.size(); i++) {
+        stress.segment<3>(6*i) = -(ply_vector_[i].Qbar_ * free_strain(i));
+        stress.segment<3>(6*i + 3) = stress.segment<3>(6*i);
+    }
+    return stress;
+}
+
+abd_index laminate::build_abd_index() const {
+    return abd_index(ply_table(ply_vector_));
+}
+
+void set_laminate_block(laminate& lam, const BlockStiffness& block) {
+    lam.A_ = block.A;
+    lam.B_ = block.B;
+    lam.D_ = block.D;
+    lam.S0_ = block.S0;
+    lam.S1_ = block.S1;
+    lam.S2_ = block.S2;
+    lam.NT_ = block.NT;
+    lam.MT_ = block.MT;
+    lam.NH_ = block.NH;
+    lam.MH_ = block.MH;
+    lam.height_ = block.height;
+}
+
+BlockStiffness empty_block() {
+    BlockStiffness block;
+    block.A.setZero();
+    block.B.setZero();
+    block.D.setZero();
+    block.S0.setZero();
+    block.S1.setZero();
+    block.S2.setZero();
+    block.NT.setZero();
+    block.MT.setZero();
+    block.NH.setZero();
+    block.MH.setZero();
+    block.height = 0.;
+    return block;
+}
+
+void add_ply_moments(BlockStiffness& block, const ply& p, double bottom, 
+                     double top, double sign) {
+    double w0 = sign * (top - bottom);
+    double w1 = w0 * (top + bottom) / 2;
+    double w2 = w0 * (top*top + top*bottom + bottom*bottom) / 3;
+    Vector3d Q_alpha = p.Qbar_ * p.alpha_;
+    Vector3d Q_beta = p.Qbar_ * p.beta_;
+    block.A += w0 * p.Qbar_;
+    block.B += w1 * p.Qbar_;
+    block.D += w2 * p.Qbar_;
+    block.S0 += w0 * p.Qs_;
+    block.S1 += w1 * p.Qs_;
+    block.S2 += w2 * p.Qs_;
+    block.NT += w0 * Q_alpha;
+    block.MT += w1 * Q_alpha;
+    block.NH += w0 * Q_beta;
+    block.MH += w1 * Q_beta;
 }
 
+BlockStiffness single_ply_block(const ply& p) {
+    BlockStiffness block = empty_block();
+    add_ply_moments(block, p, -p.thickness_/2, p.thickness_/2, 1.);
+    block.height = p.thickness_;
+    return block;
+}
 
+void build_block_tree(laminate& lam) {
+    if (!lam.block_tree_.empty()) {
+        return;
+    }
+    std::size_t leaf_count = 1;
+    while (leaf_count < lam.ply_vector_.size()) {
+        leaf_count *= 2;
+    }
+    // The leaves past the last ply stay empty, which stack as nothing.
+    lam.block_tree_.assign(2 * leaf_count, empty_block());
+    for (std::size_t i = 0; i < lam.ply_vector_.size(); i++) {
+        lam.block_tree_[leaf_count + i] = single_ply_block(lam.ply_vector_[i]);
+    }
+    for (std::size_t k = leaf_count - 1; k > 0; k--) {
+        lam.block_tree_[k] = 
+            stack_blocks(lam.block_tree_[2*k], lam.block_tree_[2*k + 1]);
+    }
+}
+
+void update_ply_block(laminate& lam, std::size_t i) {
+    build_block_tree(lam);
+    std::size_t k = lam.block_tree_.size() / 2 + i;
+    lam.block_tree_[k] = single_ply_block(lam.ply_vector_[i]);
+    for (k /= 2; k > 0; k /= 2) {
+        lam.block_tree_[k] = 
+            stack_blocks(lam.block_tree_[2*k], lam.block_tree_[2*k + 1]);
+    }
+    set_laminate_block(lam, lam.block_tree_[1]);
+    solve_mid_strain(lam, lam.load_vector_);
+    lam.profile_segments_stale_ = true;
+}
+
+void replace_ply(laminate& lam, std::size_t i, const ply& new_ply) {
+    lam.ply_vector_[i] = new_ply;
+    update_ply_block(lam, i);
+}
+
+void laminate::set_ply_angle(std::size_t i, double theta) {
+    const ply& old_ply = ply_vector_[i];
+    replace_ply(*this, i, ply(old_ply.material_label_, 
+        old_ply.material_properties_, theta, old_ply.thickness_));
+}
+
+void laminate::set_ply_material(std::size_t i, const string& material_label,
+                                const Properties& material_properties) {
+    const ply& old_ply = ply_vector_[i];
+    replace_ply(*this, i, ply(material_label, material_properties, 
+                              old_ply.theta_, old_ply.thickness_));
+}
+
+void laminate::set_ply_thickness(std::size_t i, double thickness) {
+    if (!(thickness > 0) || !std::isfinite(thickness)) {
+        cout << "Error: plies must be thicker than 0." << endl;
+        return;
+    }
+    // The plies above move with the edited one: the tree stacks every node
+    // on top of the one below it, so only the heights change.
+    ply_vector_[i].thickness_ = thickness;
+    update_ply_block(*this, i);
+}
+
+void solve_profile_segments(const laminate& lam) {
+    lam.profile_segments_.clear();
+    lam.profile_segments_.reserve(lam.ply_vector_.size());
+    double bottom_coordinate = -lam.height_/2;
+    for (auto it = lam.ply_vector_.begin(); it != lam.ply_vector_.end(); it++) {
+        PlySegment segment;
+        segment.bottom_pt = bottom_coordinate;
+        segment.top_pt = bottom_coordinate + it->thickness_;
+        segment.bottom_strain = 
+            lam.mid_strain_ + segment.bottom_pt * lam.mid_curvature_;
+        segment.top_strain = 
+            lam.mid_strain_ + segment.top_pt * lam.mid_curvature_;
+        // Only the strain beyond the free thermal and moisture strain of 
+        // the ply is stressed.
+        Vector3d free = lam.free_strain(it - lam.ply_vector_.begin());
+        segment.bottom_stress = it->Qbar_ * (segment.bottom_strain - free);
+        segment.top_stress = it->Qbar_ * (segment.top_strain - free);
+        lam.profile_segments_.push_back(segment);
+        bottom_coordinate = segment.top_pt;
+    }
+    lam.profile_segments_stale_ = false;
+}
+
+void laminate::sample_profile(double pt_spacing, unsigned thread_count) {
+    // The view brings the profile segments up to date before the threads
+    // read them.
+    profile_view view(*this, pt_spacing);
+    const std::size_t sample_count = view.size();
+    stresses_.resize(sample_count);
+    strains_.resize(sample_count);
+    profile_pt_.resize(sample_count);
+    thread_count = parallel_thread_count(thread_count, sample_count,
+                                         kParallelThreshold);
+
+    // Each range starts with a binary search for its first ply and then 
+    // walks the plies upwards with the view iterator.
+    parallel_ranges(sample_count, thread_count,
+                    [&](std::size_t first, std::size_t last) {
+        auto it = view.at(first);
+        for (std::size_t i = first; i < last; i++, ++it) {
+            ProfileSample sample = *it;
+            profile_pt_[i] = sample.pt;
+            stresses_[i] = sample.stress;
+            strains_[i] = sample.strain;
+        }
+    });
+}
@@ -0,0 +1,393 @@
+//! Implementation of the laminate_code.
+
+#include <iostream>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <charconv>
+#include <cctype>
+#include <cstdint>
+#include "../include/laminate_code.h"
+#include "../include/tokenizer.h"
+
+// Position of the parser in the text of the code.
+struct CodeCursor {
+    std::string_view text;
+    std::size_t pos;
+};
+
+// Print why the code is invalid and return false.
+bool code_error(const CodeCursor& cursor, const char* reason);
+
+// Skip the item separators "/", "," and whitespace.
+void skip_separators(CodeCursor& cursor);
+
+// Consume token if the text continues with it.
+bool consume(CodeCursor& cursor, std::string_view token);
+
+// Parse the items up to the closing character into a group node of code.
+// depth is 0 for the brackets of the code and at most kMaxCodeDepth.
+bool parse_sequence(CodeCursor& cursor, laminate_code& code, char close,
+                    int depth);
+
+// Parse one item (ply, pair or group) with its repeat count.
+bool parse_item(CodeCursor& cursor, laminate_code& code, int depth);
+
+// Parse an angle, with an optional leading sign.
+bool parse_angle(CodeCursor& cursor, double& angle);
+
+// Parse a positive count.
+bool parse_count(CodeCursor& cursor, int& count);
+
+// Parse the subscript after the closing bracket.
+bool parse_subscript(CodeCursor& cursor, SubscriptInfo& info);
+
+// Add the number of plies of each angle in the subtree at node, times
+// multiplier, to counts. The angles are reduced to (-90, 90]. Returns false
+// if a count overflows.
+bool count_angles(const laminate_code& code, int node,
+                  std::uint64_t multiplier,
+                  std::map<double, std::uint64_t>& counts);
+
+// Store a * b or a + b into result. Return false if it overflows.
+bool checked_multiply(std::uint64_t a, std::uint64_t b, std::uint64_t& result);
+bool checked_add(std::uint64_t a, std::uint64_t b, std::uint64_t& result);
+
+// Reduce an angle to (-90, 90].
+double reduce_angle(double angle);
+
+using std::endl;
+using std::string_view; using std::map; using std::uint64_t;
+
+bool parse_laminate_code(string_view text, laminate_code& result) {
+    result.nodes_.clear();
+    result.has_mid_ply_ = false;
+    result.leaf_count_ = 0;
+
+    CodeCursor cursor{text, 0};
+    while (cursor.pos < text.size() &&
+           (text[cursor.pos] == ' ' || text[cursor.pos] == '\t')) {
+        cursor.pos++;
+    }
+    if (!consume(cursor, "[")) {
+        return code_error(cursor, "expected '['");
+    }
+    if (!parse_sequence(cursor, result, ']', 0)
+        || !parse_subscript(cursor, result.subscript_)) {
+        return false;
+    }
+    result.nodes_[0].repeat = result.subscript_.pre_count;
+
+    if (result.has_mid_ply_ && (!result.subscript_.has_symmetry
+                                || result.subscript_.pre_count != 1)) {
+        return code_error(cursor,
+            "a barred ply needs an 's' subscript without a count before it");
+    }
+    uint64_t ply_count;
+    if (!result.checked_ply_count(ply_count)) {
+        return code_error(cursor, "too many plies");
+    }
+    return true;
+}
+
+bool is_extended_code(string_view code) {
+    for (string_view token : {"(", "_", "\xC2\xB1", "\xE2\x88\x93", "+-",
+                              "-+", "bar", "\xCC\x84", "\xCC\x85"}) {
+        if (code.find(token) != string_view::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint64_t laminate_code::ply_count() const {
+    uint64_t count = 0;
+    checked_ply_count(count);
+    return count;
+}
+
+bool laminate_code::checked_ply_count(uint64_t& count) const {
+    if (!node_ply_count(0, count)) {
+        return false;
+    }
+    if (subscript_.has_symmetry) {
+        if (!checked_multiply(count, 2, count)) {
+            return false;
+        }
+        count -= has_mid_ply_ ? 1 : 0;
+    }
+    return checked_multiply(count, 
+        subscript_.post_count > 0 ? subscript_.post_count : 1, count);
+}
+
+bool laminate_code::is_symmetric() const {
+    return subscript_.has_symmetry;
+}
+
+bool laminate_code::is_balanced() const {
+    map<double, uint64_t> counts;
+    uint64_t multiplier = subscript_.has_symmetry ? 2 : 1;
+    if (has_mid_ply_) {
+        // The root repeat is 1 here, so the children are counted directly
+        // and the mid-plane ply only once.
+        int last = nodes_.size() - 1;
+        for (int c = 1; c < last; c += nodes_[c].size) {
+            if (!count_angles(*this, c, multiplier, counts)) {
+                return false;
+            }
+        }
+        if (!count_angles(*this, last, 1, counts)) {
+            return false;
+        }
+    } else if (!count_angles(*this, 0, multiplier, counts)) {
+        return false;
+    }
+    for (const auto& [angle, count] : counts) {
+        if (angle == 0. || angle == 90.) {
+            continue;
+        }
+        auto opposite = counts.find(-angle);
+        if (opposite == counts.end() || opposite->second != count) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool laminate_code::node_ply_count(int node, uint64_t& count) const {
+    const CodeNode& n = nodes_[node];
+    count = 0;
+    switch (n.kind) {
+        case CodeNodeKind::ply:
+            count = 1;
+            break;
+        case CodeNodeKind::pair:
+            count = 2;
+            break;
+        case CodeNodeKind::group:
+            for (int c = node + 1; c < node + n.size; c += nodes_[c].size) {
+                uint64_t child_count;
+                if (!node_ply_count(c, child_count)
+                    || !checked_add(count, child_count, count)) {
+                    return false;
+                }
+            }
+            break;
+    }
+    return checked_multiply(count, n.repeat, count);
+}
+
+bool code_error(const CodeCursor& cursor, const char* reason) {
+    parser_messages() << "Invalid laminate code " << cursor.text << ": " 
+                      << reason << " at column " << cursor.pos + 1 << "." 
+                      << endl;
+    return false;
+}
+
+void skip_separators(CodeCursor& cursor) {
+    while (cursor.pos < cursor.text.size()
+           && string_view(" \t\r,/").find(cursor.text[cursor.pos])
+                != string_view::npos) {
+        cursor.pos++;
+    }
+}
+
+bool consume(CodeCursor& cursor, string_view token) {
+    if (cursor.text.substr(cursor.pos, token.size()) == token) {
+        cursor.pos += token.size();
+        return true;
+    }
+    return false;
+}
+
+bool parse_sequence(CodeCursor& cursor, laminate_code& code, char close,
+                    int depth) {
+    std::size_t group = code.nodes_.size();
+    code.nodes_.push_back({CodeNodeKind::group, 0., 1, 1, -1, -1});
+    int previous_child = -1;
+    while (true) {
+        skip_separators(cursor);
+        if (cursor.pos == cursor.text.size()) {
+            return code_error(cursor, close == ']' ? "missing ']'"
+                                                   : "missing ')'");
+        }
+        if (cursor.text[cursor.pos] == close) {
+            cursor.pos++;
+            break;
+        }
+        if (cursor.text[cursor.pos] == ']' || cursor.text[cursor.pos] == ')') {
+            return code_error(cursor, "unbalanced parenthesis");
+        }
+        if (code.has_mid_ply_) {
+            return code_error(cursor, "the barred ply must be the last ply");
+        }
+        int child = code.nodes_.size();
+        if (!parse_item(cursor, code, depth)) {
+            return false;
+        }
+        code.nodes_[child].previous = previous_child;
+        previous_child = child;
+    }
+    if (code.nodes_.size() == group + 1) {
+        return code_error(cursor, "empty group");
+    }
+    code.nodes_[group].size = code.nodes_.size() - group;
+    return true;
+}
+
+bool parse_item(CodeCursor& cursor, laminate_code& code, int depth) {
+    std::size_t item = code.nodes_.size();
+    double angle;
+    if (consume(cursor, "(")) {
+        if (depth == kMaxCodeDepth) {
+            return code_error(cursor, "groups nested too deeply");
+        }
+        if (!parse_sequence(cursor, code, ')', depth + 1)) {
+            return false;
+        }
+        // The count of a group may follow the parenthesis directly.
+        if (cursor.pos < cursor.text.size()
+            && std::isdigit(static_cast<unsigned char>(
+                cursor.text[cursor.pos]))
+            && !parse_count(cursor, code.nodes_[item].repeat)) {
+            return false;
+        }
+    } else if (consume(cursor, "\xC2\xB1") || consume(cursor, "+-")) {
+        if (!parse_angle(cursor, angle)) {
+            return false;
+        }
+        code.nodes_.push_back(
+            {CodeNodeKind::pair, angle, 1, 1, code.leaf_count_++, -1});
+    } else if (consume(cursor, "\xE2\x88\x93") || consume(cursor, "-+")) {
+        if (!parse_angle(cursor, angle)) {
+            return false;
+        }
+        code.nodes_.push_back(
+            {CodeNodeKind::pair, -angle, 1, 1, code.leaf_count_++, -1});
+    } else {
+        if (!parse_angle(cursor, angle)) {
+            return false;
+        }
+        code.nodes_.push_back(
+            {CodeNodeKind::ply, angle, 1, 1, code.leaf_count_++, -1});
+        if (consume(cursor, "bar") || consume(cursor, "\xCC\x85")
+            || consume(cursor, "\xCC\x84")) {
+            if (depth != 0) {
+                return code_error(cursor,
+                    "the barred ply cannot be inside a group");
+            }
+            code.has_mid_ply_ = true;
+            return true;  // The mid-plane ply is never repeated.
+        }
+    }
+    if (consume(cursor, "_")
+        && !parse_count(cursor, code.nodes_[item].repeat)) {
+        return false;
+    }
+    return true;
+}
+
+bool parse_angle(CodeCursor& cursor, double& angle) {
+    const char* first = cursor.text.data() + cursor.pos;
+    const char* last = cursor.text.data() + cursor.text.size();
+    if (first != last && *first == '+') {
+        first++;
+    }
+    auto [end, ec] = std::from_chars(first, last, angle);
+    if (ec != std::errc() || !std::isfinite(angle)) {
+        return code_error(cursor, "expected an angle");
+    }
+    cursor.pos = end - cursor.text.data();
+    return true;
+}
+
+bool parse_count(CodeCursor& cursor, int& count) {
+    const char* first = cursor.text.data() + cursor.pos;
+    const char* last = cursor.text.data() + cursor.text.size();
+    auto [end, ec] = std::from_chars(first, last, count);
+    if (ec != std::errc() || count <= 0) {
+        return code_error(cursor, "expected a positive count");
+    }
+    cursor.pos = end - cursor.text.data();
+    return true;
+}
+
+bool parse_subscript(CodeCursor& cursor, SubscriptInfo& info) {
+    info.pre_count = 1;
+    info.has_symmetry = false;
+    info.post_count = 0;
+    string_view text = cursor.text;
+    auto at_digit = [&]() {
+        return cursor.pos < text.size()
+            && std::isdigit(static_cast<unsigned char>(text[cursor.pos]));
+    };
+    if (at_digit() && !parse_count(cursor, info.pre_count)) {
+        return false;
+    }
+    if (consume(cursor, "s") || consume(cursor, "S")) {
+        info.has_symmetry = true;
+        info.post_count = 1;
+        if (at_digit() && !parse_count(cursor, info.post_count)) {
+            return false;
+        }
+    }
+    // Whitespace (e.g. a carriage return) after the code is ignored.
+    while (cursor.pos < text.size() && string_view(" \t\r").find(
+               text[cursor.pos]) != string_view::npos) {
+        cursor.pos++;
+    }
+    if (cursor.pos != text.size()) {
+        return code_error(cursor, "unexpected subscript");
+    }
+    return true;
+}
+
+bool count_angles(const laminate_code& code, int node, uint64_t multiplier,
+                  map<double, uint64_t>& counts) {
+    const CodeNode& n = code.nodes_[node];
+    if (!checked_multiply(multiplier, n.repeat, multiplier)) {
+        return false;
+    }
+    switch (n.kind) {
+        case CodeNodeKind::ply: {
+            uint64_t& count = counts[reduce_angle(n.angle)];
+            return checked_add(count, multiplier, count);
+        }
+        case CodeNodeKind::pair: {
+            uint64_t& count = counts[reduce_angle(n.angle)];
+            if (!checked_add(count, multiplier, count)) {
+                return false;
+            }
+            uint64_t& opposite = counts[reduce_angle(-n.angle)];
+            return checked_add(opposite, multiplier, opposite);
+        }
+        case CodeNodeKind::group:
+            for (int c = node + 1; c < node + n.size; 
+                 c += code.nodes_[c].size) {
+                if (!count_angles(code, c, multiplier, counts)) {
+                    return false;
+                }
+            }
+            break;
+    }
+    return true;
+}
+
+bool checked_multiply(uint64_t a, uint64_t b, uint64_t& result) {
+    return !__builtin_mul_overflow(a, b, &result);
+}
+
+bool checked_add(uint64_t a, uint64_t b, uint64_t& result) {
+    return !__builtin_add_overflow(a, b, &result);
+}
+
+double reduce_angle(double angle) {
+    double reduced = std::fmod(angle, 180.);
+    if (reduced <= -90.) {
+        reduced += 180.;
+    } else if (reduced > 90.) {
+        reduced -= 180.;
+    }
+    return reduced;
+}
@@ -0,0 +1,147 @@
+//! Implementation of the reusable laminate solver.
+
+#include <Eigen/Dense>
+#include <vector>
+#include <cstddef>
+#include <cmath>
+#include "../include/clt_core.h"
+#include "../include/ply.h"
+#include "../include/ply_table.h"
+#include "../include/abd_solver.h"
+#include "../include/laminate_solver.h"
+
+using std::vector;
+using Eigen::Matrix; using Eigen::Matrix3d; using Eigen::Matrix2d;
+using Eigen::Vector3d;
+
+laminate_solver::laminate_solver(std::size_t capacity):
+    capacity_(capacity), ply_count_(0), properties_(capacity), 
+    invariants_(capacity), theta_(capacity), thickness_(capacity), 
+    Qbar_(capacity), Qs_(capacity), alpha_(capacity), beta_(capacity),
+    height_(0.),
+    A_(Matrix3d::Zero()), B_(Matrix3d::Zero()), D_(Matrix3d::Zero()),
+    S0_(Matrix2d::Zero()), S1_(Matrix2d::Zero()), S2_(Matrix2d::Zero()),
+    As_(Matrix2d::Zero()), NT_(Vector3d::Zero()), MT_(Vector3d::Zero()),
+    NH_(Vector3d::Zero()), MH_(Vector3d::Zero()),
+    compliance_(), engineering_constants_(), mid_strain_(Vector3d::Zero()),
+    mid_curvature_(Vector3d::Zero()), profile_segments_(capacity) {}
+
+bool laminate_solver::set_plies(const vector<ply>& ply_vector) {
+    if (ply_vector.size() > capacity_) {
+        return false;
+    }
+    ply_count_ = ply_vector.size();
+    for (std::size_t i = 0; i < ply_count_; i++) {
+        const ply& p = ply_vector[i];
+        properties_[i] = p.material_properties_;
+        invariants_[i] = build_invariants(p.material_properties_);
+        theta_[i] = p.theta_;
+        thickness_[i] = p.thickness_;
+        Qbar_[i] = p.Qbar_;
+        Qs_[i] = p.Qs_;
+        alpha_[i] = p.alpha_;
+        beta_[i] = p.beta_;
+    }
+    return true;
+}
+
+bool laminate_solver::set_plies(const vector<BasicLamina<double>>& plies) {
+    if (plies.size() > capacity_) {
+        return false;
+    }
+    ply_count_ = plies.size();
+    for (std::size_t i = 0; i < ply_count_; i++) {
+        set_ply(i, plies[i].properties, plies[i].theta, plies[i].thickness);
+    }
+    return true;
+}
+
+void laminate_solver::set_ply(std::size_t i, 
+                              const Properties& material_properties,
+                              double theta, double thickness) {
+    properties_[i] = material_properties;
+    invariants_[i] = build_invariants(material_properties);
+    thickness_[i] = thickness;
+    set_ply_angle(i, theta);
+}
+
+void laminate_solver::set_ply_angle(std::size_t i, double theta) {
+    theta_[i] = theta;
+    Qbar_[i] = build_Qbar(invariants_[i], theta);
+    Qs_[i] = build_Qs(properties_[i], theta);
+    alpha_[i] = transform_expansion(properties_[i].alpha1, 
+                                    properties_[i].alpha2, theta);
+    beta_[i] = transform_expansion(properties_[i].beta1, 
+                                   properties_[i].beta2, theta);
+}
+
+bool laminate_solver::set_ply_thickness(std::size_t i, double thickness) {
+    if (!(thickness > 0) || !std::isfinite(thickness)) {
+        return false;
+    }
+    thickness_[i] = thickness;
+    return true;
+}
+
+void laminate_solver::solve(const Matrix<double, 6, 1>& load_vector,
+                            double delta_T, double delta_C) {
+    CompensatedSum total = {0., 0.};
+    for (std::size_t i = 0; i < ply_count_; i++) {
+        total.add(thickness_[i]);
+    }
+    height_ = total.value();
+
+    // Same factored weights and compensated interface coordinates as the 
+    // ply table, accumulated ply by ply.
+    A_.setZero();
+    B_.setZero();
+    D_.setZero();
+    S0_.setZero();
+    S1_.setZero();
+    S2_.setZero();
+    NT_.setZero();
+    MT_.setZero();
+    NH_.setZero();
+    MH_.setZero();
+    CompensatedSum prefix = {0., 0.};
+    double bottom = -height_/2;
+    for (std::size_t i = 0; i < ply_count_; i++) {
+        prefix.add(thickness_[i]);
+        double top = prefix.value() - height_/2;
+        double w0 = thickness_[i];
+        double w1 = w0 * (top + bottom) / 2;
+        double w2 = w0 * (top*top + top*bottom + bottom*bottom) / 3;
+        A_ += w0 * Qbar_[i];
+        B_ += w1 * Qbar_[i];
+        D_ += w2 * Qbar_[i];
+        S0_ += w0 * Qs_[i];
+        S1_ += w1 * Qs_[i];
+        S2_ += w2 * Qs_[i];
+        Vector3d Q_alpha = Qbar_[i] * alpha_[i];
+        Vector3d Q_beta = Qbar_[i] * beta_[i];
+        NT_ += w0 * Q_alpha;
+        MT_ += w1 * Q_alpha;
+        NH_ += w0 * Q_beta;
+        MH_ += w1 * Q_beta;
+        profile_segments_[i].bottom_pt = bottom;
+        profile_segments_[i].top_pt = top;
+        bottom = top;
+    }
+
+    compliance_ = invert_abd(A_, B_, D_);
+    engineering_constants_ = engineering_constants(compliance_, height_);
+    As_ = transverse_shear_stiffness(S0_, S2_, height_);
+    Vector3d N = load_vector.head<3>() + delta_T * NT_ + delta_C * NH_;
+    Vector3d M = load_vector.tail<3>() + delta_T * MT_ + delta_C * MH_;
+    mid_strain_ = compliance_.a * N + compliance_.b * M;
+    mid_curvature_ = compliance_.b.transpose() * N + compliance_.d * M;
+
+    for (std::size_t i = 0; i < ply_count_; i++) {
+        PlySegment& segment = profile_segments_[i];
+        segment.bottom_strain = mid_strain_ + segment.bottom_pt * mid_curvature_;
+        segment.top_strain = mid_strain_ + segment.top_pt * mid_curvature_;
+        Vector3d free = delta_T * alpha_[i] + delta_C * beta_[i];
+        segment.bottom_stress = Qbar_[i] * (segment.bottom_strain - free);
+        segment.top_stress = Qbar_[i] * (segment.top_strain - free);
+    }
+}
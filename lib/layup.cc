@@ -0,0 +1,144 @@
+//! Implementation of the compressed layup.
+
+#include <Eigen/Dense>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include "../include/ply.h"
+#include "../include/layup.h"
+#include "../include/ply_table.h"
+
+// Number of times the base sequence (with its mirror) is repeated after the 
+// symmetry operation. The subscript parser sets post_count to 0 when no 
+// symmetry is given.
+int post_repetition(const SubscriptInfo& info);
+
+using std::vector;
+using Eigen::Matrix3d;
+
+BlockStiffness ply_block_stiffness(const vector<ply>& plies) {
+    return accumulate_abd(ply_table(plies));
+}
+
+BlockStiffness shift_block(const BlockStiffness& block, double offset) {
+    BlockStiffness shifted;
+    shifted.height = block.height;
+    shifted.A = block.A;
+    shifted.B = block.B + offset * block.A;
+    shifted.D = block.D + 2 * offset * block.B + offset * offset * block.A;
+    shifted.S0 = block.S0;
+    shifted.S1 = block.S1 + offset * block.S0;
+    shifted.S2 = block.S2 + 2 * offset * block.S1 + offset * offset * block.S0;
+    shifted.NT = block.NT;
+    shifted.MT = block.MT + offset * block.NT;
+    shifted.NH = block.NH;
+    shifted.MH = block.MH + offset * block.NH;
+    return shifted;
+}
+
+BlockStiffness stack_blocks(const BlockStiffness& lower, 
+                            const BlockStiffness& upper) {
+    // The mid-plane of the lower block is upper.height/2 below the mid-plane
+    // of the combined block, and vice versa.
+    BlockStiffness lower_shifted = shift_block(lower, -upper.height/2);
+    BlockStiffness upper_shifted = shift_block(upper, lower.height/2);
+    BlockStiffness stacked;
+    stacked.height = lower.height + upper.height;
+    stacked.A = lower_shifted.A + upper_shifted.A;
+    stacked.B = lower_shifted.B + upper_shifted.B;
+    stacked.D = lower_shifted.D + upper_shifted.D;
+    stacked.S0 = lower_shifted.S0 + upper_shifted.S0;
+    stacked.S1 = lower_shifted.S1 + upper_shifted.S1;
+    stacked.S2 = lower_shifted.S2 + upper_shifted.S2;
+    stacked.NT = lower_shifted.NT + upper_shifted.NT;
+    stacked.MT = lower_shifted.MT + upper_shifted.MT;
+    stacked.NH = lower_shifted.NH + upper_shifted.NH;
+    stacked.MH = lower_shifted.MH + upper_shifted.MH;
+    return stacked;
+}
+
+BlockStiffness mirror_block(const BlockStiffness& block) {
+    // z -> -z about the mid-plane: only the odd moment changes sign.
+    BlockStiffness mirrored = block;
+    mirrored.B = -block.B;
+    mirrored.S1 = -block.S1;
+    mirrored.MT = -block.MT;
+    mirrored.MH = -block.MH;
+    return mirrored;
+}
+
+BlockStiffness repeat_block(const BlockStiffness& block, int count) {
+    // Copy k sits at offset (k - (count-1)/2) * height. The offsets sum to 
+    // zero, and their squares sum to height^2 * count * (count^2 - 1) / 12.
+    BlockStiffness repeated;
+    double n = count;
+    repeated.height = n * block.height;
+    repeated.A = n * block.A;
+    repeated.B = n * block.B;
+    repeated.D = n * block.D 
+        + block.height * block.height * n * (n * n - 1) / 12 * block.A;
+    repeated.S0 = n * block.S0;
+    repeated.S1 = n * block.S1;
+    repeated.S2 = n * block.S2 
+        + block.height * block.height * n * (n * n - 1) / 12 * block.S0;
+    repeated.NT = n * block.NT;
+    repeated.MT = n * block.MT;
+    repeated.NH = n * block.NH;
+    repeated.MH = n * block.MH;
+    return repeated;
+}
+
+int post_repetition(const SubscriptInfo& info) {
+    return std::max(info.post_count, 1);
+}
+
+layup::layup(const vector<ply>& base_plies, const SubscriptInfo& subscript):
+    base_plies_(base_plies), subscript_(subscript) {}
+
+std::size_t expanded_ply_count(const SubscriptInfo& subscript, 
+                               std::size_t base_count) {
+    std::size_t count = base_count * subscript.pre_count;
+    if (subscript.has_symmetry) {
+        count *= 2;
+    }
+    return count * post_repetition(subscript);
+}
+
+std::size_t base_ply_index(const SubscriptInfo& subscript, 
+                           std::size_t base_count, std::size_t i) {
+    std::size_t repeated_size = base_count * subscript.pre_count;
+    std::size_t period = subscript.has_symmetry ? 2 * repeated_size 
+                                                : repeated_size;
+    i %= period;
+    if (i >= repeated_size) {  // in the mirrored half
+        i = period - 1 - i;
+    }
+    return i % base_count;
+}
+
+std::size_t layup::ply_count() const {
+    return expanded_ply_count(subscript_, base_plies_.size());
+}
+
+const ply& layup::ply_at(std::size_t i) const {
+    return base_plies_[base_ply_index(subscript_, base_plies_.size(), i)];
+}
+
+BlockStiffness layup::stiffness() const {
+    BlockStiffness block = ply_block_stiffness(base_plies_);
+    block = repeat_block(block, subscript_.pre_count);
+    if (subscript_.has_symmetry) {
+        block = stack_blocks(block, mirror_block(block));
+    }
+    return repeat_block(block, post_repetition(subscript_));
+}
+
+vector<ply> layup::expand() const {
+    vector<ply> laminate_vec;
+    std::size_t count = ply_count();
+    laminate_vec.reserve(count);
+    for (std::size_t i = 0; i < count; i++) {
+        laminate_vec.push_back(ply_at(i));
+    }
+    return laminate_vec;
+}
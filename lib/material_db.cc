@@ -0,0 +1,180 @@
+//! Implementation of the material_db.
+
+#include <iostream>
+#include <fstream>
+#include <map>
+#include <string>
+#include <string_view>
+#include <cstring>
+#include <cstdint>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../include/material_db.h"
+
+// The magic number at the start of a database file.
+constexpr char kMaterialDbMagic[8] = {'L', 'M', 'C', 'M', 'A', 'T', 'D', 'B'};
+
+// Size of the header: magic, record size and record count.
+constexpr std::size_t kMaterialDbHeaderSize =
+    sizeof(kMaterialDbMagic) + 2 * sizeof(std::uint32_t);
+
+// Number of property values of a record.
+constexpr std::size_t kMaterialValueCount = 10;
+
+// Size of a record: label and property values.
+constexpr std::size_t kMaterialRecordSize =
+    kMaterialLabelSize + kMaterialValueCount * sizeof(double);
+
+// The label of the record, without the NUL padding.
+std::string_view record_label(const char* record);
+
+// The properties stored in the record.
+Properties record_properties(const char* record);
+
+using std::cout; using std::endl;
+using std::string; using std::string_view; using std::map;
+using std::uint32_t;
+
+material_db::material_db(const string& filename)
+    : data_(nullptr), size_(0), count_(0) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == 0
+        && std::size_t(file_stat.st_size) >= kMaterialDbHeaderSize) {
+        void* mapped = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE,
+                            fd, 0);
+        if (mapped != MAP_FAILED) {
+            data_ = static_cast<const char*>(mapped);
+            size_ = file_stat.st_size;
+        }
+    }
+    close(fd);  // The mapping stays valid after the file is closed.
+    if (data_ == nullptr) {
+        return;
+    }
+
+    uint32_t record_size;
+    std::memcpy(&record_size, data_ + sizeof(kMaterialDbMagic),
+                sizeof(record_size));
+    std::memcpy(&count_, data_ + sizeof(kMaterialDbMagic) + sizeof(uint32_t),
+                sizeof(count_));
+    if (std::memcmp(data_, kMaterialDbMagic, sizeof(kMaterialDbMagic)) != 0
+        || record_size != kMaterialRecordSize
+        || size_ < kMaterialDbHeaderSize + count_ * kMaterialRecordSize) {
+        cout << "Error: " << filename << " is not a valid material database."
+             << endl;
+        munmap(const_cast<char*>(data_), size_);
+        data_ = nullptr;
+        size_ = 0;
+        count_ = 0;
+    }
+}
+
+material_db::~material_db() {
+    if (data_ != nullptr) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+}
+
+bool material_db::is_open() const {
+    return data_ != nullptr;
+}
+
+bool material_db::find(string_view label, Properties& p) const {
+    const char* records = data_ + kMaterialDbHeaderSize;
+    uint32_t low = 0;
+    uint32_t high = count_;
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        const char* record = records + mid * kMaterialRecordSize;
+        int order = record_label(record).compare(label);
+        if (order == 0) {
+            p = record_properties(record);
+            return true;
+        } else if (order < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return false;
+}
+
+map<string, Properties> material_db::all() const {
+    map<string, Properties> materials;
+    const char* records = data_ + kMaterialDbHeaderSize;
+    for (uint32_t i = 0; i < count_; i++) {
+        const char* record = records + i * kMaterialRecordSize;
+        // The records are sorted, so every insertion goes to the end.
+        materials.emplace_hint(materials.end(), record_label(record),
+                               record_properties(record));
+    }
+    return materials;
+}
+
+bool is_material_db(const string& filename) {
+    char magic[sizeof(kMaterialDbMagic)];
+    std::ifstream file(filename, std::ios::binary);
+    return file.read(magic, sizeof(magic))
+        && std::memcmp(magic, kMaterialDbMagic, sizeof(magic)) == 0;
+}
+
+bool write_material_db(const map<string, Properties>& materials,
+                       const string& filename) {
+    for (const auto& [label, p] : materials) {
+        if (label.size() >= kMaterialLabelSize) {
+            cout << "Error: material label " << label << " is longer than "
+                 << kMaterialLabelSize - 1 << " characters." << endl;
+            return false;
+        }
+    }
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        cout << "Error: Cannot open file " << filename << "." << endl;
+        return false;
+    }
+    uint32_t record_size = kMaterialRecordSize;
+    uint32_t count = materials.size();
+    file.write(kMaterialDbMagic, sizeof(kMaterialDbMagic));
+    file.write(reinterpret_cast<const char*>(&record_size),
+               sizeof(record_size));
+    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+
+    // std::map iterates in the byte order of the labels, which is the order
+    // the binary search of find expects.
+    for (const auto& [label, p] : materials) {
+        char record[kMaterialRecordSize] = {};
+        std::memcpy(record, label.data(), label.size());
+        double values[kMaterialValueCount] = {p.E1, p.E2, p.nu12, p.G12,
+            p.G13, p.G23, p.alpha1, p.alpha2, p.beta1, p.beta2};
+        std::memcpy(record + kMaterialLabelSize, values, sizeof(values));
+        file.write(record, sizeof(record));
+    }
+    return bool(file);
+}
+
+string_view record_label(const char* record) {
+    return string_view(record, strnlen(record, kMaterialLabelSize));
+}
+
+Properties record_properties(const char* record) {
+    double values[kMaterialValueCount];
+    std::memcpy(values, record + kMaterialLabelSize, sizeof(values));
+    Properties p;
+    p.E1 = values[0];
+    p.E2 = values[1];
+    p.nu12 = values[2];
+    p.G12 = values[3];
+    p.G13 = values[4];
+    p.G23 = values[5];
+    p.alpha1 = values[6];
+    p.alpha2 = values[7];
+    p.beta1 = values[8];
+    p.beta2 = values[9];
+    return p;
+}
@@ -0,0 +1,412 @@
+//! Implementation of the pcomp_reader.
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <unordered_set>
+#include <algorithm>
+#include <charconv>
+#include <cctype>
+#include <cmath>
+#include <Eigen/Dense>
+#include "../include/pcomp_reader.h"
+#include "../include/tokenizer.h"
+#include "../include/parallel_ranges.h"
+
+// Number of data fields on each line of a small-field card.
+constexpr std::size_t kBulkFieldsPerLine = 8;
+
+// Width of a small fixed field.
+constexpr std::size_t kBulkFieldWidth = 8;
+
+// A bulk data card: its name and the data fields of all its lines, 8 per
+// line, without the continuation fields.
+struct BulkCard {
+    std::string_view name;
+    std::vector<std::string_view> fields;
+    std::size_t line_number;
+};
+
+// Split a line into its first field and its 8 data fields (blank fields are
+// empty), in the free-field format if it has a comma or a tab and in the
+// small fixed-field format otherwise.
+void split_bulk_line(std::string_view line, std::string_view& first,
+                     std::vector<std::string_view>& fields);
+
+// Cut the line of text that starts at pos, without its '\n', and move pos to
+// the next line. Returns false at the end of the text.
+bool next_line(std::string_view text, std::size_t& pos, 
+               std::string_view& line);
+
+// True if the line is the BEGIN BULK line, in any case. Comment lines are
+// never.
+bool is_begin_bulk(std::string_view line);
+
+// Remove the surrounding spaces of a field.
+std::string_view trim_field(std::string_view field);
+
+// Case-insensitive comparison of a card name.
+bool same_name(std::string_view name, std::string_view expected);
+
+// Convert a real field, including the Nastran short exponent (1.5+7, 7.-3)
+// and a D exponent. Returns false for a blank or invalid field.
+bool parse_nastran_real(std::string_view field, double& value);
+
+// Convert an integer field. Returns false for a blank or invalid field.
+bool parse_nastran_int(std::string_view field, int& value);
+
+// Add a complete PCOMP or MAT8 card to the deck. Other cards are ignored, and
+// a card whose PID or MID is already in the deck is reported and skipped.
+// pids holds the PIDs of the PCOMP cards of the deck.
+void add_bulk_card(const BulkCard& card, NastranDeck& deck,
+                   std::unordered_set<int>& pids);
+
+// Read a PCOMP card. Returns false if a field is invalid.
+bool parse_pcomp(const BulkCard& card, PcompCard& pcomp);
+
+// Read a MAT8 card. Returns false if a field is invalid.
+bool parse_mat8(const BulkCard& card, int& mid, Properties& p);
+
+// Stiffness of one PCOMP card about its reference plane. plies is a buffer
+// reused between cards.
+PcompResult evaluate_pcomp(const PcompCard& card,
+                           const std::map<int, Properties>& materials,
+                           std::vector<BasicLamina<double>>& plies);
+
+using std::cout; using std::endl;
+using std::string; using std::string_view; using std::vector; using std::map;
+
+bool read_nastran_deck(const string& filename, NastranDeck& deck) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        cout << "Error: Cannot open file " << filename << "." << endl;
+        return false;
+    }
+    // The whole deck is read at once, so the fields are views of one buffer.
+    file.seekg(0, std::ios::end);
+    string text(static_cast<std::size_t>(file.tellg()), '\0');
+    file.seekg(0, std::ios::beg);
+    file.read(&text[0], text.size());
+    string_view line;
+    bool has_begin_bulk = false;
+    for (std::size_t pos = 0; !has_begin_bulk && next_line(text, pos, line);) {
+        has_begin_bulk = is_begin_bulk(line);
+    }
+    bool in_bulk = !has_begin_bulk;
+
+    std::unordered_set<int> pids;
+    for (const PcompCard& pcomp : deck.pcomps_) {
+        pids.insert(pcomp.pid);
+    }
+    BulkCard card{string_view(), {}, 0};
+    string_view first;
+    vector<string_view> line_fields;
+    std::size_t line_number = 0;
+    std::size_t pos = 0;
+    while (next_line(text, pos, line)) {
+        line_number++;
+        if (line.empty() || line[0] == '$') {
+            continue;
+        }
+        if (!in_bulk) {
+            in_bulk = is_begin_bulk(line);
+            continue;
+        }
+        split_bulk_line(line, first, line_fields);
+        if (same_name(trim_field(first), "ENDDATA")) {
+            break;
+        }
+        bool continuation = trim_field(first).empty() || first[0] == '+'
+            || first[0] == '*';
+        if (!continuation) {
+            add_bulk_card(card, deck, pids);
+            card.name = trim_field(first);
+            card.fields.clear();
+            card.line_number = line_number;
+        }
+        card.fields.insert(card.fields.end(), line_fields.begin(),
+                           line_fields.end());
+    }
+    add_bulk_card(card, deck, pids);
+    return true;
+}
+
+vector<PcompResult> evaluate_pcomps(const NastranDeck& deck,
+                                    unsigned thread_count) {
+    std::size_t card_count = deck.pcomps_.size();
+    vector<PcompResult> results(card_count);
+    // A card costs far more than a ply, so every deck is split by default.
+    thread_count = parallel_thread_count(thread_count, card_count, 0);
+
+    // Each thread evaluates a contiguous range of cards into its own slots.
+    parallel_ranges(card_count, thread_count,
+                    [&](std::size_t begin, std::size_t end) {
+        vector<BasicLamina<double>> plies;
+        for (std::size_t i = begin; i < end; i++) {
+            results[i] = evaluate_pcomp(deck.pcomps_[i], deck.materials_,
+                                        plies);
+        }
+    });
+    return results;
+}
+
+long long write_pcomp_results(const vector<PcompResult>& results,
+                              const string& filename) {
+    std::ofstream result_file(filename);
+    if (!result_file.is_open()) {
+        cout << "Error: Cannot open file " << filename << "." << endl;
+        return -1;
+    }
+    long long rows = 0;
+    for (const PcompResult& result : results) {
+        if (!result.valid) {
+            continue;
+        }
+        const BlockStiffness& s = result.stiffness;
+        result_file << result.pid << ' ' << s.height;
+        for (const Eigen::Matrix3d* m : {&s.A, &s.B, &s.D}) {
+            result_file << ' ' << (*m)(0, 0) << ' ' << (*m)(0, 1) << ' '
+                        << (*m)(0, 2) << ' ' << (*m)(1, 1) << ' '
+                        << (*m)(1, 2) << ' ' << (*m)(2, 2);
+        }
+        result_file << '\n';
+        rows++;
+    }
+    return rows;
+}
+
+void split_bulk_line(string_view line, string_view& first,
+                     vector<string_view>& fields) {
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    fields.assign(kBulkFieldsPerLine, string_view());
+    if (line.find_first_of(",\t") != string_view::npos) {
+        std::size_t start = 0;
+        for (std::size_t i = 0; i <= kBulkFieldsPerLine; i++) {
+            std::size_t end = line.find_first_of(",\t", start);
+            string_view field = line.substr(
+                start, end == string_view::npos ? string_view::npos
+                                                : end - start);
+            if (i == 0) {
+                first = field;
+            } else {
+                fields[i - 1] = trim_field(field);
+            }
+            if (end == string_view::npos) {
+                break;
+            }
+            start = end + 1;
+        }
+    } else {
+        first = line.substr(0, kBulkFieldWidth);
+        for (std::size_t i = 0; i < kBulkFieldsPerLine; i++) {
+            std::size_t start = (i + 1) * kBulkFieldWidth;
+            if (start < line.size()) {
+                fields[i] = trim_field(line.substr(start, kBulkFieldWidth));
+            }
+        }
+    }
+}
+
+bool next_line(string_view text, std::size_t& pos, string_view& line) {
+    if (pos >= text.size()) {
+        return false;
+    }
+    std::size_t end = std::min(text.find('\n', pos), text.size());
+    line = text.substr(pos, end - pos);
+    pos = end + 1;
+    return true;
+}
+
+bool is_begin_bulk(string_view line) {
+    return !line.empty() && line[0] != '$'
+        && same_name(trim_field(line).substr(0, 10), "BEGIN BULK");
+}
+
+string_view trim_field(string_view field) {
+    std::size_t begin = field.find_first_not_of(" \r");
+    if (begin == string_view::npos) {
+        return string_view();
+    }
+    std::size_t end = field.find_last_not_of(" \r");
+    return field.substr(begin, end - begin + 1);
+}
+
+bool same_name(string_view name, string_view expected) {
+    return name.size() == expected.size()
+        && std::equal(name.begin(), name.end(), expected.begin(),
+                      [](char a, char b) {
+                          return std::toupper(static_cast<unsigned char>(a))
+                              == b;
+                      });
+}
+
+bool parse_nastran_real(string_view field, double& value) {
+    if (field.empty()) {
+        return false;
+    }
+    if (parse_number(field, value)) {
+        return true;
+    }
+    // Rewrite 1.5+7, 7.-3 and 1.5D7 with an E exponent.
+    char buffer[64];
+    if (field.size() + 1 >= sizeof(buffer)) {
+        return false;
+    }
+    std::size_t length = 0;
+    for (std::size_t i = 0; i < field.size(); i++) {
+        char c = field[i];
+        if (c == 'D' || c == 'd') {
+            c = 'E';
+        } else if ((c == '+' || c == '-') && i > 0 && field[i - 1] != 'E'
+                   && field[i - 1] != 'e' && field[i - 1] != 'D'
+                   && field[i - 1] != 'd') {
+            buffer[length++] = 'E';
+        }
+        buffer[length++] = c;
+    }
+    return parse_number(string_view(buffer, length), value);
+}
+
+bool parse_nastran_int(string_view field, int& value) {
+    return !field.empty() && parse_number(field, value);
+}
+
+void add_bulk_card(const BulkCard& card, NastranDeck& deck,
+                   std::unordered_set<int>& pids) {
+    if (same_name(card.name, "PCOMP")) {
+        PcompCard pcomp;
+        if (!parse_pcomp(card, pcomp)) {
+            cout << "Error: invalid PCOMP card at line " << card.line_number
+                 << "." << endl;
+        } else if (!pids.insert(pcomp.pid).second) {
+            cout << "Error: PCOMP " << pcomp.pid << " at line " 
+                 << card.line_number << " is a duplicate and is skipped." 
+                 << endl;
+        } else {
+            deck.pcomps_.push_back(std::move(pcomp));
+        }
+    } else if (same_name(card.name, "MAT8")) {
+        int mid;
+        Properties p;
+        if (parse_mat8(card, mid, p)) {
+            if (!deck.materials_.emplace(mid, p).second) {
+                cout << "Error: MAT8 " << mid << " at line " 
+                     << card.line_number << " is a duplicate and is skipped."
+                     << endl;
+            }
+        } else {
+            cout << "Error: invalid MAT8 card at line " << card.line_number
+                 << "." << endl;
+        }
+    } else if (same_name(card.name, "PCOMP*")
+               || same_name(card.name, "MAT8*")) {
+        cout << "Error: large-field card at line " << card.line_number
+             << " is not supported." << endl;
+    }
+}
+
+bool parse_pcomp(const BulkCard& card, PcompCard& pcomp) {
+    const vector<string_view>& f = card.fields;
+    if (!parse_nastran_int(f[0], pcomp.pid)) {
+        return false;
+    }
+    pcomp.has_z0 = !f[1].empty();
+    if (pcomp.has_z0 && !parse_nastran_real(f[1], pcomp.z0)) {
+        return false;
+    }
+    pcomp.symmetric = same_name(f[7], "SYM");
+    pcomp.supported = f[7].empty() || pcomp.symmetric;
+    if (!pcomp.supported) {
+        cout << "Error: LAM option " << f[7] << " of PCOMP " << pcomp.pid
+             << " is not supported." << endl;
+    }
+
+    // Plies start on the second line, 4 fields (MID, T, THETA, SOUT) each.
+    pcomp.plies.clear();
+    for (std::size_t i = kBulkFieldsPerLine; i + 3 < f.size(); i += 4) {
+        if (f[i].empty() && f[i + 1].empty() && f[i + 2].empty()
+            && f[i + 3].empty()) {
+            continue;
+        }
+        PcompPly ply;
+        if (f[i].empty() || f[i + 1].empty()) {
+            if (pcomp.plies.empty()) {
+                return false;  // Nothing to repeat for the first ply.
+            }
+            ply = pcomp.plies.back();
+        }
+        ply.theta = 0.;
+        if ((!f[i].empty() && !parse_nastran_int(f[i], ply.mid))
+            || (!f[i + 1].empty()
+                && !parse_nastran_real(f[i + 1], ply.thickness))
+            || (!f[i + 2].empty()
+                && !parse_nastran_real(f[i + 2], ply.theta))
+            || !std::isfinite(ply.theta)
+            || !(ply.thickness > 0) || !std::isfinite(ply.thickness)) {
+            return false;
+        }
+        pcomp.plies.push_back(ply);
+    }
+    return !pcomp.plies.empty();
+}
+
+bool parse_mat8(const BulkCard& card, int& mid, Properties& p) {
+    vector<string_view> f = card.fields;
+    f.resize(2 * kBulkFieldsPerLine);
+    if (!parse_nastran_int(f[0], mid) || !parse_nastran_real(f[1], p.E1)
+        || !parse_nastran_real(f[2], p.E2)
+        || !parse_nastran_real(f[3], p.nu12)) {
+        return false;
+    }
+    // Blank optional fields are 0. Field 7 (RHO) is not used.
+    struct { std::size_t index; double* value; } optional[] = {
+        {4, &p.G12}, {5, &p.G13}, {6, &p.G23}, {8, &p.alpha1}, 
+        {9, &p.alpha2}};
+    for (const auto& field : optional) {
+        *field.value = 0.;
+        if (!f[field.index].empty()
+            && !parse_nastran_real(f[field.index], *field.value)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+PcompResult evaluate_pcomp(const PcompCard& card,
+                           const map<int, Properties>& materials,
+                           vector<BasicLamina<double>>& plies) {
+    PcompResult result;
+    result.pid = card.pid;
+    result.valid = card.supported;
+    plies.clear();
+    for (const PcompPly& p : card.plies) {
+        auto material = materials.find(p.mid);
+        if (material == materials.end()) {
+            cout << "Error: PCOMP " << card.pid << " uses the unknown MAT8 "
+                 << p.mid << "." << endl;
+            result.valid = false;
+            break;
+        }
+        plies.push_back({material->second, p.theta, p.thickness});
+    }
+    if (!result.valid) {
+        return result;
+    }
+    if (card.symmetric) {
+        std::size_t half = plies.size();
+        plies.reserve(2 * half);
+        for (std::size_t i = half; i > 0; i--) {
+            plies.push_back(plies[i - 1]);
+        }
+    }
+    BlockStiffness mid_plane = assemble_abd(plies);
+    // The mid-plane lies at z = Z0 + h/2 above the reference plane.
+    double offset = card.has_z0 ? card.z0 + mid_plane.height / 2 : 0.;
+    result.stiffness = shift_block(mid_plane, offset);
+    return result;
+}
@@ -2,15 +2,9 @@
 #include <cmath>
 #include <iostream>
 #include "../include/ply.h"
+#include "../include/qbar_cache.h"
 
 
-
-
-// contruct the stiffness matrix of the ply in the ply coordinates. P
-Eigen::Matrix3d build_Q(const Properties& p);
-
-double to_radian(double angle_degree);
-
 using std::cin; using std::cout; using std::endl;
 using Eigen::Matrix3d;
 
@@ -21,39 +15,13 @@ ply::ply(const std::string material_label,
     material_properties_(material_properties), theta_(theta), 
     thickness_(thickness) {
     
-    double angle_radian = to_radian(theta);
-    double s = sin(angle_radian);
-    double c = cos(angle_radian);
-    Matrix3d T_stress_inv;
-    Matrix3d T_strain;
-
-    T_stress_inv << pow(c,2), pow(s,2), -2*s*c,
-                    pow(s,2), pow(c,2),  2*s*c,
-                    s*c     , -s*c    ,  pow(c,2) - pow(s,2);
-
-    T_strain << pow(c,2), pow(s,2),  s*c,
-                pow(s,2), pow(c,2), -s*c,
-                -2*s*c     , 2*s*c  ,  pow(c,2) - pow(s,2);    
-    
-    Matrix3d Q = build_Q(material_properties_);
-
-    // Transformation from ply coordinates to laminate coordinates.
-    Qbar_ = T_stress_inv * Q * T_strain;
+    CachedStiffness stiffness = 
+        cached_stiffness(material_label_, material_properties_, theta_);
+    Qbar_ = stiffness.Qbar;
+    Qs_ = stiffness.Qs;
+    alpha_ = transform_expansion(material_properties_.alpha1, 
+                                 material_properties_.alpha2, theta_);
+    beta_ = transform_expansion(material_properties_.beta1, 
+                                material_properties_.beta2, theta_);
 
 }
-
-Matrix3d build_Q(const Properties& p) {
-    double D = 1 - p.E2 / p.E1 * pow(p.nu12, 2);
-    Matrix3d Q;
-
-    Q << p.E1/D       , p.nu12*p.E2/D, 0,
-         p.nu12*p.E2/D, p.E2/D       , 0,
-         0            , 0            , p.G12;
-
-    return Q;
-}
-
-double to_radian(double angle_degree) {
-    return angle_degree * M_PI/180;
-}
-
@@ -0,0 +1,152 @@
+//! Implementation of the ply table and the ABD kernel.
+
+#include <Eigen/Dense>
+#include <vector>
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+#include "../include/ply.h"
+#include "../include/layup.h"
+#include "../include/ply_table.h"
+#include "../include/parallel_ranges.h"
+
+// Number of plies in each chunk of the ABD accumulation. Fixed, so that the
+// partial sums do not depend on the number of threads.
+const Eigen::Index kChunkSize = 256;
+
+// Moments of the plies [begin, begin + count), one column per A, B, D. Each
+// column holds the unique entries of Qbar in QbarEntry order, the ones of Qs
+// in QsEntry order, and Qbar alpha and Qbar beta (only the first two columns
+// of these are used).
+Eigen::Matrix<double, 15, 3> chunk_moments(const ply_table& table, 
+    Eigen::Index begin, Eigen::Index count);
+
+using std::vector;
+using Eigen::ArrayXd; using Eigen::Matrix; using Eigen::Matrix3d;
+
+ply_table::ply_table(const vector<ply>& plies):
+    z_(plies.size() + 1), thickness_(plies.size()), qbar_(plies.size(), 6),
+    qs_(plies.size(), 3), q_expansion_(plies.size(), 6) {
+    for (std::size_t i = 0; i < plies.size(); i++) {
+        const ply& p = plies[i];
+        thickness_(i) = p.thickness_;
+        qbar_(i, kQ11) = p.Qbar_(0, 0);
+        qbar_(i, kQ12) = p.Qbar_(0, 1);
+        qbar_(i, kQ16) = p.Qbar_(0, 2);
+        qbar_(i, kQ22) = p.Qbar_(1, 1);
+        qbar_(i, kQ26) = p.Qbar_(1, 2);
+        qbar_(i, kQ66) = p.Qbar_(2, 2);
+        qs_(i, kQ44) = p.Qs_(0, 0);
+        qs_(i, kQ45) = p.Qs_(0, 1);
+        qs_(i, kQ55) = p.Qs_(1, 1);
+        q_expansion_.row(i).head<3>() = (p.Qbar_ * p.alpha_).transpose();
+        q_expansion_.row(i).tail<3>() = (p.Qbar_ * p.beta_).transpose();
+    }
+    // z_ temporarily holds the distance of each interface from the bottom.
+    CompensatedSum prefix = {0., 0.};
+    z_(0) = 0.;
+    for (std::size_t i = 0; i < plies.size(); i++) {
+        prefix.add(thickness_(i));
+        z_(i + 1) = prefix.value();
+    }
+    double height = z_(plies.size());
+    z_ -= height/2;
+}
+
+std::size_t ply_table::size() const {
+    return thickness_.size();
+}
+
+BlockStiffness accumulate_abd(const ply_table& table, unsigned thread_count) {
+    const Eigen::Index n = table.size();
+    const Eigen::Index chunk_count = (n + kChunkSize - 1) / kChunkSize;
+    thread_count = parallel_thread_count(thread_count, n, kParallelThreshold);
+
+    // Each thread fills a contiguous range of chunks.
+    vector<Matrix<double, 15, 3>> partial(chunk_count);
+    parallel_ranges(chunk_count, thread_count,
+                    [&](std::size_t first_chunk, std::size_t last_chunk) {
+        for (Eigen::Index c = first_chunk; c < Eigen::Index(last_chunk); c++) {
+            Eigen::Index begin = c * kChunkSize;
+            partial[c] = chunk_moments(table, begin, 
+                                       std::min(kChunkSize, n - begin));
+        }
+    });
+
+    // Combine the partial sums in chunk order.
+    Matrix<double, 15, 3> moments;
+    for (int k = 0; k < moments.size(); k++) {
+        CompensatedSum entry = {0., 0.};
+        for (Eigen::Index c = 0; c < chunk_count; c++) {
+            entry.add(partial[c](k));
+        }
+        moments(k) = entry.value();
+    }
+
+    BlockStiffness block;
+    block.height = table.z_(n) - table.z_(0);
+    block.A = unpack_symmetric(moments.col(0).head<6>());
+    block.B = unpack_symmetric(moments.col(1).head<6>());
+    block.D = unpack_symmetric(moments.col(2).head<6>());
+    block.S0 = unpack_shear(moments.col(0).segment<3>(6));
+    block.S1 = unpack_shear(moments.col(1).segment<3>(6));
+    block.S2 = unpack_shear(moments.col(2).segment<3>(6));
+    block.NT = moments.col(0).segment<3>(9);
+    block.MT = moments.col(1).segment<3>(9);
+    block.NH = moments.col(0).segment<3>(12);
+    block.MH = moments.col(1).segment<3>(12);
+    return block;
+}
+
+Matrix<double, 15, 3> chunk_moments(const ply_table& table, 
+    Eigen::Index begin, Eigen::Index count) {
+    auto thickness = table.thickness_.segment(begin, count);
+    auto bottom = table.z_.segment(begin, count);
+    auto top = table.z_.segment(begin + 1, count);
+
+    // Through-thickness weights of each ply. The factored forms avoid the 
+    // cancellation of top^2 - bottom^2 and top^3 - bottom^3.
+    Matrix<double, Eigen::Dynamic, 3> weights(count, 3);
+    weights.col(0) = thickness.matrix();
+    weights.col(1) = (thickness * (top + bottom) / 2).matrix();
+    weights.col(2) = (thickness 
+        * (top.square() + top * bottom + bottom.square()) / 3).matrix();
+
+    Matrix<double, 15, 3> moments;
+    moments.topRows<6>() = 
+        table.qbar_.middleRows(begin, count).transpose() * weights;
+    moments.middleRows<3>(6) = 
+        table.qs_.middleRows(begin, count).transpose() * weights;
+    moments.bottomRows<6>() = 
+        table.q_expansion_.middleRows(begin, count).transpose() * weights;
+    return moments;
+}
+
+void CompensatedSum::add(double value) {
+    double t = sum + value;
+    if (std::abs(sum) >= std::abs(value)) {
+        compensation += (sum - t) + value;
+    } else {
+        compensation += (value - t) + sum;
+    }
+    sum = t;
+}
+
+double CompensatedSum::value() const {
+    return sum + compensation;
+}
+
+Matrix3d unpack_symmetric(const Matrix<double, 6, 1>& entries) {
+    Matrix3d M;
+    M << entries(kQ11), entries(kQ12), entries(kQ16),
+         entries(kQ12), entries(kQ22), entries(kQ26),
+         entries(kQ16), entries(kQ26), entries(kQ66);
+    return M;
+}
+
+Eigen::Matrix2d unpack_shear(const Matrix<double, 3, 1>& entries) {
+    Eigen::Matrix2d M;
+    M << entries(kQ44), entries(kQ45),
+         entries(kQ45), entries(kQ55);
+    return M;
+}
@@ -0,0 +1,105 @@
+//! Implementation of the lazy profile view.
+
+#include <iostream>
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cassert>
+#include "../include/laminate.h"
+#include "../include/profile_view.h"
+
+using Eigen::Vector3d;
+
+profile_view::profile_view(const laminate& lam, double pt_spacing):
+    lam_(&lam), pt_spacing_(pt_spacing), interval_count_(0) {
+    lam.profile_segments();
+    if (!(pt_spacing > 0) || !std::isfinite(pt_spacing)) {
+        std::cout << "Error: the profile spacing must be greater than 0." 
+                  << std::endl;
+        pt_spacing_ = 0.;
+        return;
+    }
+    if (!lam.ply_vector_.empty()) {
+        interval_count_ = 
+            static_cast<std::size_t>(std::ceil(lam.height_ / pt_spacing));
+    }
+}
+
+std::size_t profile_view::size() const {
+    return lam_->ply_vector_.empty() || pt_spacing_ == 0. 
+        ? 0 : interval_count_ + 1;
+}
+
+double profile_view::pt(std::size_t i) const {
+    return std::min(-lam_->height_/2 + i * pt_spacing_, lam_->height_/2);
+}
+
+std::size_t profile_view::layer_of(double pt) const {
+    const auto& segments = lam_->profile_segments_;
+    auto it = std::lower_bound(segments.begin(), segments.end(), pt,
+        [](const PlySegment& segment, double value) {
+            return segment.top_pt < value;
+        });
+    if (it == segments.end()) {
+        return segments.size() - 1;
+    }
+    return it - segments.begin();
+}
+
+ProfileSample profile_view::operator[](std::size_t i) const {
+    assert(i < size());
+    return *at(i);
+}
+
+profile_view::iterator profile_view::at(std::size_t i) const {
+    if (i >= size()) {
+        return end();
+    }
+    return iterator{this, i, layer_of(pt(i))};
+}
+
+profile_view::iterator profile_view::begin() const {
+    return iterator{this, 0, 0};
+}
+
+profile_view::iterator profile_view::end() const {
+    return iterator{this, size(), 0};
+}
+
+ProfileSample profile_view::iterator::operator*() const {
+    const laminate& lam = *view_->lam_;
+    ProfileSample sample;
+    sample.pt = view_->pt(index_);
+    sample.strain = lam.mid_strain_ + sample.pt * lam.mid_curvature_;
+    sample.stress = lam.ply_vector_[layer_].Qbar_ 
+        * (sample.strain - lam.free_strain(layer_));
+    return sample;
+}
+
+profile_view::iterator& profile_view::iterator::operator++() {
+    index_++;
+    if (index_ < view_->size()) {
+        const laminate& lam = *view_->lam_;
+        double next_pt = view_->pt(index_);
+        while (next_pt > lam.profile_segments_[layer_].top_pt 
+               && layer_ + 1 < lam.profile_segments_.size()) {
+            layer_++;
+        }
+    }
+    return *this;
+}
+
+profile_view::iterator profile_view::iterator::operator++(int) {
+    iterator previous = *this;
+    ++(*this);
+    return previous;
+}
+
+bool profile_view::iterator::operator==(const iterator& other) const {
+    return view_ == other.view_ && index_ == other.index_;
+}
+
+bool profile_view::iterator::operator!=(const iterator& other) const {
+    return !(*this == other);
+}
@@ -0,0 +1,142 @@
+//! Implementation of the Qbar cache.
+
+#include <Eigen/Dense>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <functional>
+#include <mutex>
+#include <cmath>
+#include "../include/ply.h"
+#include "../include/qbar_cache.h"
+
+// Key of a cached entry.
+struct QbarKey {
+    int material_id;
+    double theta;
+
+    bool operator==(const QbarKey& other) const {
+        return material_id == other.material_id && theta == other.theta;
+    }
+};
+
+struct QbarKeyHash {
+    std::size_t operator()(const QbarKey& key) const {
+        std::size_t h = std::hash<double>()(key.theta);
+        return h ^ (std::hash<int>()(key.material_id) + 0x9e3779b9 
+                    + (h << 6) + (h >> 2));
+    }
+};
+
+// An interned material.
+struct MaterialEntry {
+    Properties properties;
+    Invariants invariants;
+};
+
+// Compare all material properties.
+bool same_properties(const Properties& p, const Properties& q);
+
+// Build the entry of the material at the angle theta.
+CachedStiffness build_stiffness(const MaterialEntry& material, double theta);
+
+// Return the id of the material, registering it if it is new, and look up
+// its stiffness, with cache_mutex already held.
+int intern_material_locked(const std::string& label, const Properties& p);
+CachedStiffness cached_stiffness_locked(int material_id, double theta);
+
+// Empty the cache and the material table, with cache_mutex already held.
+void clear_locked();
+
+using std::string;
+using std::vector;
+
+// The cache state, guarded by cache_mutex.
+namespace {
+std::mutex cache_mutex;
+vector<MaterialEntry> materials;
+std::multimap<string, int> material_ids;
+std::unordered_map<QbarKey, CachedStiffness, QbarKeyHash> qbar_cache;
+QbarCacheStats cache_stats = {0, 0, 0};
+}
+
+CachedStiffness cached_stiffness(const string& label, const Properties& p,
+                                 double theta) {
+    if (!std::isfinite(theta)) {
+        // A NaN key never compares equal, so it would be inserted every call.
+        return build_stiffness(MaterialEntry{p, build_invariants(p)}, theta);
+    }
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    return cached_stiffness_locked(intern_material_locked(label, p), theta);
+}
+
+QbarCacheStats qbar_cache_stats() {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    QbarCacheStats stats = cache_stats;
+    stats.materials = materials.size();
+    return stats;
+}
+
+void clear_qbar_cache() {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    clear_locked();
+    cache_stats = QbarCacheStats{0, 0, 0};
+}
+
+void clear_locked() {
+    qbar_cache.clear();
+    materials.clear();
+    material_ids.clear();
+}
+
+int intern_material_locked(const string& label, const Properties& p) {
+    auto range = material_ids.equal_range(label);
+    for (auto it = range.first; it != range.second; it++) {
+        if (same_properties(materials[it->second].properties, p)) {
+            return it->second;
+        }
+    }
+    if (materials.size() >= kQbarCacheMaterials) {
+        // The ids of the cached entries go with the table. No id outlives
+        // the lock, so nothing else refers to them.
+        clear_locked();
+    }
+    int id = materials.size();
+    materials.push_back(MaterialEntry{p, build_invariants(p)});
+    material_ids.insert({label, id});
+    return id;
+}
+
+CachedStiffness build_stiffness(const MaterialEntry& material, double theta) {
+    return CachedStiffness{build_Qbar(material.invariants, theta),
+                           build_Qs(material.properties, theta)};
+}
+
+CachedStiffness cached_stiffness_locked(int material_id, double theta) {
+    if (!std::isfinite(theta)) {
+        return build_stiffness(materials[material_id], theta);
+    }
+    // -0 and +0 are the same orientation but hash differently.
+    QbarKey key{material_id, theta == 0. ? 0. : theta};
+    auto it = qbar_cache.find(key);
+    if (it != qbar_cache.end()) {
+        cache_stats.hits++;
+        return it->second;
+    }
+    cache_stats.misses++;
+    CachedStiffness stiffness = build_stiffness(materials[material_id], theta);
+    if (qbar_cache.size() >= kQbarCacheCapacity) {
+        // Start over rather than track recency: the working set of a real
+        // layup is far below the capacity, so this only happens in sweeps.
+        qbar_cache.clear();
+    }
+    qbar_cache.insert({key, stiffness});
+    return stiffness;
+}
+
+bool same_properties(const Properties& p, const Properties& q) {
+    return p.E1 == q.E1 && p.E2 == q.E2 && p.nu12 == q.nu12 && p.G12 == q.G12
+        && p.G13 == q.G13 && p.G23 == q.G23 && p.alpha1 == q.alpha1 
+        && p.alpha2 == q.alpha2 && p.beta1 == q.beta1 && p.beta2 == q.beta2;
+}
@@ -0,0 +1,115 @@
+//! Implementation of the tokenizer.
+
+#include <iostream>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+#include <charconv>
+#include <system_error>
+#include "../include/tokenizer.h"
+
+// Convert the whole token with std::from_chars.
+template <typename Number>
+bool parse_whole(std::string_view token, Number& value);
+
+using std::string_view;
+using std::vector;
+
+// The redirected parser messages of each thread, nullptr for std::cout.
+namespace {
+thread_local std::ostream* parser_stream = nullptr;
+}
+
+std::ostream& parser_messages() {
+    return parser_stream != nullptr ? *parser_stream : std::cout;
+}
+
+void set_parser_messages(std::ostream* messages) {
+    parser_stream = messages;
+}
+
+tokenizer::tokenizer(string_view text, string_view delimiters):
+    text_(text), delimiters_(delimiters), pos_(0) {}
+
+bool tokenizer::next(string_view& token) {
+    std::size_t begin = text_.find_first_not_of(delimiters_, pos_);
+    if (begin == string_view::npos) {
+        pos_ = text_.size();
+        return false;
+    }
+    std::size_t end = text_.find_first_of(delimiters_, begin);
+    if (end == string_view::npos) {
+        end = text_.size();
+    }
+    token = text_.substr(begin, end - begin);
+    pos_ = end;
+    return true;
+}
+
+string_view bracket_contents(string_view text) {
+    std::size_t left_bracket_pos = text.find('[');
+    if (left_bracket_pos == string_view::npos) {
+        return string_view();
+    }
+    std::size_t right_bracket_pos = text.find(']', left_bracket_pos);
+    if (right_bracket_pos == string_view::npos) {
+        return string_view();
+    }
+    return text.substr(left_bracket_pos + 1, 
+                       right_bracket_pos - left_bracket_pos - 1);
+}
+
+string_view after_bracket(string_view text) {
+    std::size_t right_bracket_pos = text.find(']');
+    if (right_bracket_pos == string_view::npos) {
+        return string_view();
+    }
+    return text.substr(right_bracket_pos + 1);
+}
+
+template <typename Number>
+bool parse_whole(string_view token, Number& value) {
+    if (!token.empty() && token.front() == '+') {
+        token.remove_prefix(1);
+    }
+    const char* last = token.data() + token.size();
+    auto result = std::from_chars(token.data(), last, value);
+    return !token.empty() && result.ec == std::errc() && result.ptr == last;
+}
+
+bool parse_number(string_view token, float& value) {
+    return parse_whole(token, value);
+}
+
+bool parse_number(string_view token, double& value) {
+    return parse_whole(token, value);
+}
+
+bool parse_number(string_view token, long double& value) {
+    return parse_whole(token, value);
+}
+
+bool parse_number(string_view token, int& value) {
+    return parse_whole(token, value);
+}
+
+template <typename Number>
+bool parse_numbers(string_view text, vector<Number>& values,
+                   string_view delimiters) {
+    tokenizer tokens(text, delimiters);
+    string_view token;
+    Number value;
+    while (tokens.next(token)) {
+        if (!parse_number(token, value)) {
+            return false;
+        }
+        values.push_back(value);
+    }
+    return true;
+}
+
+template bool parse_numbers<float>(string_view, vector<float>&, string_view);
+template bool parse_numbers<double>(string_view, vector<double>&, 
+                                    string_view);
+template bool parse_numbers<long double>(string_view, vector<long double>&,
+                                         string_view);
@@ -11,6 +11,39 @@
  * `stiffness_submatrices_ABD.txt` contains the A, B, and D submatrices of the
  * composite laminate, in the given order separate by new lines.
  * 
+ * `stiffness_submatrices As.txt` contains the shear-corrected transverse 
+ * shear stiffness [A44 A45; A45 A55] of the laminate. It is zero unless the
+ * material data gives G13 and G23.
+ * 
+ * `engineering_constants.txt` contains the effective engineering constants of
+ * the laminate, one "name value" pair per line: Ex, Ey, Gxy, nuxy, nuyx, and
+ * the flexural Efx, Efy, Gfxy, nufxy, nufyx.
+ * 
+ * If `load_cases` exists, every load case in it is solved and the mid-plane
+ * strains are saved into `load_case_strains.txt`, one row per load case with
+ * the columns: strain_x, strain_y, strain_xy, kappa_x, kappa_y, kappa_xy.
+ * The ply stresses of every load case are evaluated with the unit-load basis
+ * of the laminate and saved into `load_case_ply_stresses.txt`, one row per 
+ * load case containing sigma_x, sigma_y, sigma_xy at the bottom and the top
+ * of each ply, from the bottom ply to the top ply. The temperature and 
+ * moisture change of the laminate input apply to every load case.
+ * 
+ * `laminate_main --compile-materials <material_data> <database>` compiles a
+ * text material_data file into a binary material database instead, which can
+ * be used in place of `material_data.lmc`.
+ * 
+ * `laminate_main --batch <cases> <results>` solves every case of a batch file
+ * with the materials of `material_data.lmc` and writes one result row per 
+ * case (see batch_runner.h).
+ * 
+ * `laminate_main --screen <cases> <results>` screens the cases of a batch file
+ * in single precision, re-solving the doubtful ones in double precision, and
+ * writes one result row per case (see batch_screen.h).
+ * 
+ * `laminate_main --pcomp <bulk data> <results>` reads the PCOMP and MAT8 cards
+ * of a Nastran bulk data deck and writes the A, B, D submatrices of every 
+ * PCOMP card (see pcomp_reader.h).
+ * 
  */
 
 #include <iostream>
@@ -21,32 +54,93 @@
 #include "../include/input_parser.h"
 #include "../include/ply.h"
 #include "../include/laminate.h"
+#include "../include/profile_view.h"
+#include "../include/batch_runner.h"
+#include "../include/batch_screen.h"
+#include "../include/pcomp_reader.h"
+
+void save_laminate_profile(laminate& lam, double pt_spacing);
+
+void save_engineering_constants(const EngineeringConstants& constants);
 
-void save_laminate_profile(laminate& lam);
+void save_load_case_strains(
+    const Eigen::Matrix<double, 6, Eigen::Dynamic>& case_strains);
 
-int main() {
+void save_load_case_ply_stresses(const Eigen::MatrixXd& case_stresses);
+
+int main(int argc, char* argv[]) {
+    if (argc == 4 && std::string(argv[1]) == "--compile-materials") {
+        if (!compile_material_data(argv[2], argv[3])) {
+            return 1;
+        }
+        std::cout << "Laminate_main -- Material database saved." << std::endl;
+        return 0;
+    }
+    if (argc == 4 && std::string(argv[1]) == "--batch") {
+        long long solved = 
+            run_batch(argv[2], "input_files/material_data.lmc", argv[3]);
+        if (solved < 0) {
+            return 1;
+        }
+        std::cout << "Laminate_main -- " << solved << " batch cases saved." 
+                  << std::endl;
+        return 0;
+    }
+    if (argc == 4 && std::string(argv[1]) == "--screen") {
+        long long screened = 
+            run_screen(argv[2], "input_files/material_data.lmc", argv[3]);
+        if (screened < 0) {
+            return 1;
+        }
+        std::cout << "Laminate_main -- " << screened 
+                  << " screened cases saved." << std::endl;
+        return 0;
+    }
+    if (argc == 4 && std::string(argv[1]) == "--pcomp") {
+        NastranDeck deck;
+        if (!read_nastran_deck(argv[2], deck)) {
+            return 1;
+        }
+        long long rows = write_pcomp_results(evaluate_pcomps(deck), argv[3]);
+        if (rows < 0) {
+            return 1;
+        }
+        std::cout << "Laminate_main -- " << rows << " PCOMP results saved."
+                  << std::endl;
+        return 0;
+    }
     std::vector<std::string> input_strings = 
         read_composite_input("input_files/laminate_input.lmc");
-    std::vector<ply> ply_vector = 
-        get_ply_vector(input_strings, "input_files/material_data.lmc");
+    layup plies = get_layup(input_strings, "input_files/material_data.lmc");
     Eigen::Matrix<double, 6, 1> load_vector = get_load_vector(input_strings[3]);
     double min_thickness = get_minimum_ply_thickness(input_strings[2]);
     double pt_spacing = min_thickness/20.;
-    laminate lam(ply_vector, load_vector, pt_spacing);
-    save_laminate_profile(lam);
+    Eigen::Vector2d environment = input_strings.size() > 4 
+        ? get_environment(input_strings[4]) : Eigen::Vector2d::Zero();
+    laminate lam(plies, load_vector, environment(0), environment(1));
+    save_laminate_profile(lam, pt_spacing);
+    save_engineering_constants(lam.engineering_constants_);
+    Eigen::Matrix<double, 6, Eigen::Dynamic> load_cases = 
+        get_load_cases("input_files/load_cases.lmc");
+    if (load_cases.cols() > 0) {
+        // Every load case acts together with the environment of the laminate.
+        Eigen::Matrix<double, 6, Eigen::Dynamic> total_loads = 
+            load_cases.colwise() + lam.environmental_load();
+        save_load_case_strains(lam.solve_load_cases(total_loads));
+        Eigen::Matrix<double, Eigen::Dynamic, 6> basis = lam.stress_basis();
+        save_load_case_ply_stresses(
+            (basis * total_loads).colwise() + lam.restrained_free_stress());
+    }
     std::cout << "Laminate_main -- Data saved." << std::endl;
     return 0;
 }
 
-void save_laminate_profile(laminate& lam) {
+void save_laminate_profile(laminate& lam, double pt_spacing) {
     std::ofstream profile_file;
     profile_file.open("output_files/laminate_profile_data.txt");
-    auto i_sigma = lam.stresses_.begin();
-    auto i_eps = lam.strains_.begin();
-    auto i_pt = lam.profile_pt_.begin();
-    for (; i_sigma != lam.stresses_.end(); i_sigma++, i_eps++, i_pt++) {
+    for (const ProfileSample& sample : profile_view(lam, pt_spacing)) {
         Eigen::Matrix<double, 7, 1> combined_data;
-        combined_data << *i_pt, *i_sigma, *i_eps;
+        combined_data << sample.pt, sample.stress, sample.strain;
         
         Eigen::Map<Eigen::Matrix<double, 1, 7>> 
             row(combined_data.data(), combined_data.size());
@@ -60,4 +154,36 @@ void save_laminate_profile(laminate& lam) {
     stiffness_file << std::endl << std::endl;
     stiffness_file << lam.D_;
     stiffness_file << std::endl << std::endl;
-}
\ No newline at end of file
+    std::ofstream shear_file;
+    shear_file.open("output_files/stiffness_submatrices As.txt");
+    shear_file << lam.As_;
+    shear_file << std::endl;
+}
+
+void save_engineering_constants(const EngineeringConstants& constants) {
+    std::ofstream constants_file;
+    constants_file.open("output_files/engineering_constants.txt");
+    constants_file << "Ex " << constants.Ex << std::endl;
+    constants_file << "Ey " << constants.Ey << std::endl;
+    constants_file << "Gxy " << constants.Gxy << std::endl;
+    constants_file << "nuxy " << constants.nuxy << std::endl;
+    constants_file << "nuyx " << constants.nuyx << std::endl;
+    constants_file << "Efx " << constants.Efx << std::endl;
+    constants_file << "Efy " << constants.Efy << std::endl;
+    constants_file << "Gfxy " << constants.Gfxy << std::endl;
+    constants_file << "nufxy " << constants.nufxy << std::endl;
+    constants_file << "nufyx " << constants.nufyx << std::endl;
+}
+
+void save_load_case_strains(
+    const Eigen::Matrix<double, 6, Eigen::Dynamic>& case_strains) {
+    std::ofstream strain_file;
+    strain_file.open("output_files/load_case_strains.txt");
+    strain_file << case_strains.transpose() << std::endl;
+}
+
+void save_load_case_ply_stresses(const Eigen::MatrixXd& case_stresses) {
+    std::ofstream stress_file;
+    stress_file.open("output_files/load_case_ply_stresses.txt");
+    stress_file << case_stresses.transpose() << std::endl;
+}
@@ -0,0 +1,147 @@
+//! Checks that the stiffness of a range of plies taken from the ABD index
+//! matches the stiffness accumulated over the same plies on their own, about
+//! the mid-plane of the range, for a short and a 10^4-ply stack.
+
+#include <Eigen/Dense>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cmath>
+#include "../include/ply.h"
+#include "../include/layup.h"
+#include "../include/abd_index.h"
+#include "../include/laminate.h"
+
+using std::cout; using std::endl;
+using std::string; using std::vector;
+
+// Print the check if it failed, and count the failures.
+int failures = 0;
+void check(bool passed, const std::string& what);
+
+// True if a and b agree to tolerance relative to scale.
+template <typename Matrix>
+bool close(const Matrix& a, const Matrix& b, double scale, double tolerance);
+
+// Unidirectional carbon/epoxy, with E2 scaled by stiffer.
+Properties test_material(double stiffer);
+
+// count plies of two materials and three thicknesses, with a cycle of
+// angles that is not symmetric about any plane.
+vector<ply> test_plies(std::size_t count);
+
+// Compare range(begin, end) of the index with the plies [begin, end) on
+// their own.
+void check_range(const abd_index& index, const vector<ply>& plies,
+                 std::size_t begin, std::size_t end, double tolerance);
+
+int main() {
+    // Every range of a short stack, including the empty ones.
+    vector<ply> plies = test_plies(12);
+    abd_index index{ply_table(plies)};
+    check(index.size() == plies.size(), "index size");
+    for (std::size_t begin = 0; begin <= plies.size(); begin++) {
+        for (std::size_t end = begin; end <= plies.size(); end++) {
+            check_range(index, plies, begin, end, 1e-12);
+        }
+    }
+
+    // The whole stack is the laminate itself.
+    Eigen::Matrix<double, 6, 1> load;
+    load << 1e3, 0, 0, 0, 0, 0;
+    laminate lam(plies, load);
+    BlockStiffness whole = lam.build_abd_index().range(0, plies.size());
+    check(close(whole.A, lam.A_, lam.A_.norm(), 1e-12)
+          && close(whole.B, lam.B_, lam.A_.norm() * lam.height_, 1e-12)
+          && close(whole.D, lam.D_, lam.D_.norm(), 1e-12),
+          "build_abd_index of the laminate");
+
+    // Ranges of a 10^4-ply stack. The differences of the prefixes lose the
+    // ratio of the laminate to the range height (cubed for D), so the ranges
+    // are not much thinner than the stack.
+    plies = test_plies(10000);
+    index = abd_index(ply_table(plies));
+    check_range(index, plies, 0, 10000, 1e-12);
+    check_range(index, plies, 0, 5000, 1e-10);
+    check_range(index, plies, 5000, 10000, 1e-10);
+    check_range(index, plies, 2500, 7500, 1e-10);
+    check_range(index, plies, 1, 9999, 1e-10);
+    check_range(index, plies, 8000, 9000, 1e-8);
+
+    if (failures == 0) {
+        cout << "abd_index_test: all checks passed." << endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+void check(bool passed, const std::string& what) {
+    if (!passed) {
+        cout << "abd_index_test: FAILED " << what << endl;
+        failures++;
+    }
+}
+
+template <typename Matrix>
+bool close(const Matrix& a, const Matrix& b, double scale, double tolerance) {
+    return (a - b).cwiseAbs().maxCoeff() <= tolerance * scale;
+}
+
+Properties test_material(double stiffer) {
+    Properties p;
+    p.E1 = 1.38e11;
+    p.E2 = 1.0e10 * stiffer;
+    p.nu12 = 0.34;
+    p.G12 = 7.0e9;
+    p.G13 = 7.0e9;
+    p.G23 = 3.7e9;
+    p.alpha1 = -0.3e-6;
+    p.alpha2 = 28.1e-6;
+    p.beta1 = 0;
+    p.beta2 = 0.44;
+    return p;
+}
+
+vector<ply> test_plies(std::size_t count) {
+    const double angles[] = {0, 45, -45, 90, 30, -60, 15};
+    const double thicknesses[] = {2e-4, 1.5e-4, 1e-4};
+    const Properties materials[] = {test_material(1), test_material(1.5)};
+    vector<ply> plies;
+    plies.reserve(count);
+    for (std::size_t i = 0; i < count; i++) {
+        plies.push_back(ply(i % 2 ? "M2" : "M1", materials[i % 2],
+                            angles[i % 7], thicknesses[i % 3]));
+    }
+    return plies;
+}
+
+void check_range(const abd_index& index, const vector<ply>& plies,
+                 std::size_t begin, std::size_t end, double tolerance) {
+    BlockStiffness actual = index.range(begin, end);
+    BlockStiffness expected = ply_block_stiffness(
+        vector<ply>(plies.begin() + begin, plies.begin() + end));
+    string what = "range [" + std::to_string(begin) + ", "
+        + std::to_string(end) + ")";
+    if (begin == end) {
+        check(actual.height == 0 && actual.A.isZero() && actual.D.isZero(),
+              what + " is empty");
+        return;
+    }
+    double h = expected.height;
+    double a = expected.A.norm();
+    double s = expected.S0.norm();
+    double n = expected.NT.norm() + expected.NH.norm();
+    check(std::abs(actual.height - h) <= tolerance * h, what + " height");
+    check(close(actual.A, expected.A, a, tolerance), what + " A");
+    check(close(actual.B, expected.B, a * h, tolerance), what + " B");
+    check(close(actual.D, expected.D, a * h * h, tolerance), what + " D");
+    check(close(actual.S0, expected.S0, s, tolerance)
+          && close(actual.S1, expected.S1, s * h, tolerance)
+          && close(actual.S2, expected.S2, s * h * h, tolerance),
+          what + " shear moments");
+    check(close(actual.NT, expected.NT, n, tolerance)
+          && close(actual.NH, expected.NH, n, tolerance)
+          && close(actual.MT, expected.MT, n * h, tolerance)
+          && close(actual.MH, expected.MH, n * h, tolerance),
+          what + " expansion resultants");
+}
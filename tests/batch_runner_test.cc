@@ -0,0 +1,116 @@
+//! Checks that the memory of run_batch stays flat over a sweep of random
+//! angles: the plies of the cases must not go through the Qbar cache, and the
+//! pipeline must not hold more than its window of chunks. Also checks that
+//! the messages of invalid cases are printed whole and in file order.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <random>
+#include <string>
+#include <cstdio>
+#include <sys/resource.h>
+#include "../include/batch_runner.h"
+#include "../include/qbar_cache.h"
+
+using std::cout; using std::endl;
+
+// Material data file of the repository; make test runs from its root.
+const char* const kMaterialData = "input_files/material_data.lmc";
+
+// Scratch files of the test, removed at the end.
+const char* const kCasesFile = "batch_runner_test_cases.txt";
+const char* const kResultsFile = "batch_runner_test_results.txt";
+
+// Print the check if it failed, and count the failures.
+int failures = 0;
+void check(bool passed, const std::string& what);
+
+// Write case_count cases with random angles into kCasesFile.
+void write_random_cases(std::mt19937& random, int case_count);
+
+// Peak resident set size of the process, in kilobytes.
+long peak_rss_kb();
+
+// Write case_count cases into kCasesFile, with an unknown material on every
+// seventh line, run them on four workers and check the printed messages.
+void check_invalid_cases(int case_count);
+
+int main() {
+    std::mt19937 random(2024);
+
+    // The first sweep sets the working set of the pipeline, the second one
+    // has ten times the cases and distinct angles and must not add to it.
+    write_random_cases(random, 20000);
+    long long solved = run_batch(kCasesFile, kMaterialData, kResultsFile, 2);
+    check(solved == 20000, "first sweep solved every case");
+    long first_peak = peak_rss_kb();
+
+    write_random_cases(random, 200000);
+    solved = run_batch(kCasesFile, kMaterialData, kResultsFile, 2);
+    check(solved == 200000, "second sweep solved every case");
+    long growth = peak_rss_kb() - first_peak;
+    check(growth < 4096, "peak RSS grew by " + std::to_string(growth) 
+          + " kB over the second sweep");
+
+    QbarCacheStats stats = qbar_cache_stats();
+    check(stats.hits + stats.misses == 0, "the batch did not use the cache");
+
+    check_invalid_cases(5000);
+
+    std::remove(kCasesFile);
+    std::remove(kResultsFile);
+    if (failures == 0) {
+        cout << "batch_runner_test: all checks passed." << endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+void check(bool passed, const std::string& what) {
+    if (!passed) {
+        cout << "batch_runner_test: FAILED " << what << endl;
+        failures++;
+    }
+}
+
+void write_random_cases(std::mt19937& random, int case_count) {
+    std::uniform_real_distribution<double> angle(-90., 90.);
+    std::ofstream cases(kCasesFile);
+    cases.precision(17);
+    for (int i = 0; i < case_count; i++) {
+        cases << '[' << angle(random) << '/' << angle(random) << '/' 
+              << angle(random) << '/' << angle(random) << "]2s; "
+              << "[M1, M2, M1, M2]; [2e-4, 1.5e-4, 2e-4, 1.5e-4]; "
+              << "[7e6, 0, 0, 0, 0, 0]\n";
+    }
+}
+
+long peak_rss_kb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+void check_invalid_cases(int case_count) {
+    std::string expected;
+    {
+        std::ofstream cases(kCasesFile);
+        for (int line = 1; line <= case_count; line++) {
+            bool invalid = line % 7 == 0;
+            cases << "[0/45/-45/90]s; [M1, " << (invalid ? "M9" : "M2")
+                  << ", M1, M2]; [2e-4, 1.5e-4, 2e-4, 1.5e-4]; "
+                  << "[7e6, 0, 0, 0, 0, 0]\n";
+            if (invalid) {
+                expected += "Error: unknown material M9.\n"
+                    "Error: invalid batch case at line " 
+                    + std::to_string(line) + ".\n";
+            }
+        }
+    }
+    std::ostringstream printed;
+    std::streambuf* console = cout.rdbuf(printed.rdbuf());
+    long long solved = run_batch(kCasesFile, kMaterialData, kResultsFile, 4);
+    cout.rdbuf(console);
+    check(solved == case_count - case_count / 7, "valid cases solved");
+    check(printed.str() == expected, "messages of the invalid cases");
+}
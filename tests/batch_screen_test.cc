@@ -0,0 +1,122 @@
+//! Checks that the float screening agrees with the double laminate on
+//! well-conditioned cases without refining them, and that a near-singular
+//! case is flagged and solved again in double precision.
+
+#include <Eigen/Dense>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cmath>
+#include "../include/ply.h"
+#include "../include/laminate.h"
+#include "../include/batch_screen.h"
+
+using std::cout; using std::endl;
+using std::string; using std::vector;
+
+// Print the check if it failed, and count the failures.
+int failures = 0;
+void check(bool passed, const std::string& what);
+
+// An orthotropic material with nu12 = 0.3 and G13 = G23 = G12.
+Properties test_material(double E1, double E2, double G12);
+
+// Solve the case with a laminate in double precision.
+laminate solve_with_laminate(const ScreenCase& screen_case);
+
+// True if the relative difference of a and b is at most tolerance.
+bool close(const Eigen::Matrix<double, 6, 1>& a,
+           const Eigen::Matrix<double, 6, 1>& b, double tolerance);
+
+int main() {
+    const Properties stiff = test_material(1.38e11, 1e10, 7e9);
+    const Properties soft = test_material(1e3, 1e3, 4e2);
+    Eigen::Matrix<double, 6, 1> load;
+    load << 1e3, 2e2, 10, 1, 0.5, 0.1;
+
+    // Eleven cases fill one group of lanes and part of the next. Case 5 is
+    // a thin stiff ply on a thick soft one: B^2 nearly cancels A D, which
+    // the float pivots cannot resolve.
+    const std::size_t near_singular = 5;
+    vector<ScreenCase> cases;
+    for (std::size_t i = 0; i < 11; i++) {
+        double angle = 15. * i;
+        ScreenCase screen_case;
+        screen_case.load = load;
+        if (i == near_singular) {
+            screen_case.plies = {{stiff, 0, 1e-4}, {soft, 0, 1e-2}};
+        } else {
+            screen_case.plies = {{stiff, angle, 2e-4}, {stiff, 45, 2e-4},
+                                 {stiff, -45, 2e-4}, {stiff, 90 - angle, 2e-4}};
+        }
+        cases.push_back(screen_case);
+    }
+    vector<ScreenResult> results = screen_laminates(cases, 1e-3);
+    check(results.size() == cases.size(), "one result per case");
+
+    for (std::size_t i = 0; i < cases.size(); i++) {
+        string what = "case " + std::to_string(i);
+        laminate lam = solve_with_laminate(cases[i]);
+        Eigen::Matrix<double, 6, 1> expected;
+        expected << lam.mid_strain_, lam.mid_curvature_;
+        if (i == near_singular) {
+            check(results[i].refined, what + " was refined");
+            check(close(results[i].response, expected, 1e-9),
+                  what + " refined response");
+            check(std::abs(results[i].constants.Ex
+                           - lam.engineering_constants_.Ex)
+                  <= 1e-9 * lam.engineering_constants_.Ex,
+                  what + " refined Ex");
+        } else {
+            check(!results[i].refined, what + " was not refined");
+            check(close(results[i].response, expected, 1e-3),
+                  what + " float response");
+            check(std::abs(results[i].constants.Ex
+                           - lam.engineering_constants_.Ex)
+                  <= 1e-3 * lam.engineering_constants_.Ex,
+                  what + " float Ex");
+        }
+    }
+
+    if (failures == 0) {
+        cout << "batch_screen_test: all checks passed." << endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+void check(bool passed, const std::string& what) {
+    if (!passed) {
+        cout << "batch_screen_test: FAILED " << what << endl;
+        failures++;
+    }
+}
+
+Properties test_material(double E1, double E2, double G12) {
+    Properties p;
+    p.E1 = E1;
+    p.E2 = E2;
+    p.nu12 = 0.3;
+    p.G12 = G12;
+    p.G13 = G12;
+    p.G23 = G12;
+    p.alpha1 = 0;
+    p.alpha2 = 0;
+    p.beta1 = 0;
+    p.beta2 = 0;
+    return p;
+}
+
+laminate solve_with_laminate(const ScreenCase& screen_case) {
+    vector<ply> plies;
+    for (const auto& p : screen_case.plies) {
+        plies.push_back(ply("", p.properties, p.theta, p.thickness));
+    }
+    Eigen::Matrix<double, 6, 1> load = screen_case.load;
+    return laminate(plies, load);
+}
+
+bool close(const Eigen::Matrix<double, 6, 1>& a,
+           const Eigen::Matrix<double, 6, 1>& b, double tolerance) {
+    return (a - b).norm() <= tolerance * b.norm();
+}
@@ -0,0 +1,121 @@
+//! Checks of the CLT core in the scalar types other than double: long double
+//! for reference values and Eigen::AutoDiffScalar for derivatives.
+
+#include <Eigen/Dense>
+#include <unsupported/Eigen/AutoDiff>
+#include <iostream>
+#include <string>
+#include <cmath>
+#include "../include/clt_core.h"
+#include "../include/input_parser.h"
+
+using std::cout; using std::endl;
+
+// Print the check if it failed, and count the failures.
+int failures = 0;
+void check(bool passed, const std::string& what);
+
+// Unidirectional carbon/epoxy in the precision of Scalar.
+template <typename Scalar>
+BasicProperties<Scalar> test_material();
+
+int main() {
+    using Real = long double;
+    BasicProperties<Real> p = test_material<Real>();
+    BasicInvariants<Real> u = build_invariants(p);
+
+    // The exact coefficients are rounded in long double, not in double.
+    BasicAngleCoefficients<Real> exact = {0, 0, 0, 0};
+    check(lookup_standard_angle(Real(30), exact) 
+          && exact.s2 == std::sqrt(Real(3)) / 2
+          && exact.s2 != Real(kHalfSqrt3<double>),
+          "long double 30 degree coefficients");
+    check(lookup_standard_angle(Real(-240), exact) 
+          && exact.c2 == Real(-0.5) && exact.s2 == -kHalfSqrt3<Real>,
+          "long double -240 degree coefficients");
+    Eigen::Matrix<Real, 3, 3> Qbar = build_Qbar(u, Real(90));
+    check(Qbar(0, 2) == 0 && Qbar(1, 2) == 0, "long double 90 degree coupling");
+
+    // The exact path agrees with sin and cos in long double precision.
+    Real angle = Real(60) * Real(3.14159265358979323846264338327950288L) / 180;
+    Eigen::Matrix<Real, 3, 3> trig = qbar_from_invariants(u, 
+        std::cos(2*angle), std::sin(2*angle), std::cos(4*angle), 
+        std::sin(4*angle));
+    check(((build_Qbar(u, Real(60)) - trig).norm() / trig.norm()) < 1e-17L,
+          "long double 60 degree Qbar");
+
+    // A long double load is converted without going through double.
+    std::string load_string = "[0.1, 0, 0, 0, 0, 0]";
+    check(get_load_vector<Real>(load_string)(0) == 0.1L, 
+          "long double load vector");
+
+    // d Qbar / d theta and d A / d thickness with forward AutoDiff.
+    using Derivative = Eigen::AutoDiffScalar<Eigen::Vector2d>;
+    BasicProperties<double> p_double = test_material<double>();
+    BasicProperties<Derivative> p_ad = test_material<Derivative>();
+    std::vector<BasicLamina<Derivative>> plies(2);
+    plies[0] = BasicLamina<Derivative>{p_ad, Derivative(25., 2, 0), 
+                                       Derivative(2e-4)};
+    plies[1] = BasicLamina<Derivative>{p_ad, Derivative(-45.), 
+                                       Derivative(1.5e-4, 2, 1)};
+    BasicBlockStiffness<Derivative> block = assemble_abd(plies);
+
+    const double step = 1e-6;
+    BasicInvariants<double> u_double = build_invariants(p_double);
+    double dQ11 = (build_Qbar(u_double, 25. + step)(0, 0) 
+                   - build_Qbar(u_double, 25. - step)(0, 0)) / (2 * step);
+    check(std::abs(block.A(0, 0).derivatives()(0) / 2e-4 - dQ11) 
+          < 1e-6 * std::abs(dQ11), "AutoDiff d A11 / d theta");
+    double Q11 = build_Qbar(u_double, -45.)(0, 0);
+    check(std::abs(block.A(0, 0).derivatives()(1) - Q11) < 1e-9 * Q11,
+          "AutoDiff d A11 / d thickness");
+
+    // d epsilon_x / d theta of the solved response, against central 
+    // differences of the double solve.
+    Eigen::Matrix<Derivative, 6, 1> load_ad;
+    load_ad << Derivative(1e3), Derivative(2e2), Derivative(0), 
+               Derivative(0), Derivative(0), Derivative(1.);
+    Eigen::Matrix<Derivative, 6, 1> response = solve_abd(block, load_ad);
+    auto strain_at = [&](double theta) {
+        std::vector<BasicLamina<double>> plies_double = {
+            {p_double, theta, 2e-4}, {p_double, -45., 1.5e-4}};
+        Eigen::Matrix<double, 6, 1> load_double;
+        load_double << 1e3, 2e2, 0, 0, 0, 1.;
+        return solve_abd(assemble_abd(plies_double), load_double)(0);
+    };
+    double strain = strain_at(25.);
+    double d_strain = (strain_at(25. + step) - strain_at(25. - step)) 
+                      / (2 * step);
+    check(std::abs(response(0).value() - strain) < 1e-12 * std::abs(strain),
+          "AutoDiff solve_abd value");
+    check(std::abs(response(0).derivatives()(0) - d_strain) 
+          < 1e-5 * std::abs(d_strain), "AutoDiff d epsilon_x / d theta");
+
+    if (failures == 0) {
+        cout << "clt_core_test: all checks passed." << endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+void check(bool passed, const std::string& what) {
+    if (!passed) {
+        cout << "clt_core_test: FAILED " << what << endl;
+        failures++;
+    }
+}
+
+template <typename Scalar>
+BasicProperties<Scalar> test_material() {
+    BasicProperties<Scalar> p;
+    p.E1 = Scalar(1.38e11);
+    p.E2 = Scalar(1.0e10);
+    p.nu12 = Scalar(0.34);
+    p.G12 = Scalar(7.0e9);
+    p.G13 = Scalar(7.0e9);
+    p.G23 = Scalar(3.7e9);
+    p.alpha1 = Scalar(-0.3e-6);
+    p.alpha2 = Scalar(28.1e-6);
+    p.beta1 = Scalar(0);
+    p.beta2 = Scalar(0.44);
+    return p;
+}
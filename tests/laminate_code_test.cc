@@ -0,0 +1,102 @@
+//! Checks of the extended laminate code parser: the ply count, symmetry and
+//! balance found from the AST, the order of for_each_ply, and the codes that
+//! must be rejected.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include "../include/laminate_code.h"
+
+using std::cout; using std::endl;
+using std::string; using std::vector;
+
+// Print the check if it failed, and count the failures.
+int failures = 0;
+void check(bool passed, const std::string& what);
+
+// The (angle, leaf) of every ply of the code, from bottom to top.
+using PlyList = vector<std::pair<double, int>>;
+
+// Parse the code and check its count, symmetry, balance and plies.
+void check_code(const string& code, bool symmetric, bool balanced,
+                const PlyList& expected);
+
+// Check that the code is rejected.
+void check_rejected(const string& code, const string& what);
+
+int main() {
+    // The barred ply is the mid-plane ply and is not mirrored.
+    check_code("[0/45/90bar]s", true, false,
+               {{0, 0}, {45, 1}, {90, 2}, {45, 1}, {0, 0}});
+    // A mirrored pair is walked backwards, -45 first.
+    check_code("[(0/90)2/±45_2]s", true, true,
+               {{0, 0}, {90, 1}, {0, 0}, {90, 1},
+                {45, 2}, {-45, 2}, {45, 2}, {-45, 2},
+                {-45, 2}, {45, 2}, {-45, 2}, {45, 2},
+                {90, 1}, {0, 0}, {90, 1}, {0, 0}});
+    check_code("[∓30/0_2]2", false, true,
+               {{-30, 0}, {30, 0}, {0, 1}, {0, 1},
+                {-30, 0}, {30, 0}, {0, 1}, {0, 1}});
+    check_code("[+-45/(30/-30)]", false, true,
+               {{45, 0}, {-45, 0}, {30, 1}, {-30, 2}});
+    check_code("[-+45/30_2]s", true, false,
+               {{-45, 0}, {45, 0}, {30, 1}, {30, 1},
+                {30, 1}, {30, 1}, {45, 0}, {-45, 0}});
+
+    // Counts come from the AST, without walking the plies.
+    laminate_code code;
+    check(parse_laminate_code("[(0/(±45)1000/90)1000000]s2", code)
+          && code.ply_count() == std::uint64_t(4) * 2002 * 1000000,
+          "ply count of a large code");
+
+    // The deepest nesting allowed, and one level more.
+    string deepest = "[" + string(kMaxCodeDepth, '(') + "0"
+        + string(kMaxCodeDepth, ')') + "]";
+    check(parse_laminate_code(deepest, code) && code.ply_count() == 1,
+          "nesting of kMaxCodeDepth groups");
+    check_rejected("[(" + deepest.substr(1, deepest.size() - 2) + ")]",
+                   "nesting deeper than kMaxCodeDepth");
+
+    check_rejected("[(((((0)1000000)1000000)1000000)1000000)]",
+                   "a ply count past 64 bits");
+    check_rejected("[90bar/0]s", "a barred ply before the last ply");
+    check_rejected("[0/90bar]", "a barred ply without symmetry");
+    check_rejected("[0/90bar]2s", "a barred ply with a count before 's'");
+    check_rejected("[(0/90bar)]s", "a barred ply inside a group");
+
+    if (failures == 0) {
+        cout << "laminate_code_test: all checks passed." << endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+void check(bool passed, const std::string& what) {
+    if (!passed) {
+        cout << "laminate_code_test: FAILED " << what << endl;
+        failures++;
+    }
+}
+
+void check_code(const string& code, bool symmetric, bool balanced,
+                const PlyList& expected) {
+    laminate_code parsed;
+    if (!parse_laminate_code(code, parsed)) {
+        check(false, code + " parses");
+        return;
+    }
+    check(parsed.ply_count() == expected.size(), code + " ply count");
+    check(parsed.is_symmetric() == symmetric, code + " symmetry");
+    check(parsed.is_balanced() == balanced, code + " balance");
+    PlyList plies;
+    parsed.for_each_ply([&plies](double angle, int leaf) {
+        plies.emplace_back(angle, leaf);
+    });
+    check(plies == expected, code + " ply order");
+}
+
+void check_rejected(const string& code, const string& what) {
+    laminate_code parsed;
+    check(!parse_laminate_code(code, parsed), what + " is rejected");
+}
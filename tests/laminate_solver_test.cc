@@ -0,0 +1,107 @@
+//! Checks that editing and solving a laminate_solver does no heap allocation,
+//! and that its results match the laminate struct.
+
+#include <Eigen/Dense>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <new>
+#include <cstdlib>
+#include <cstddef>
+#include <cmath>
+#include "../include/ply.h"
+#include "../include/laminate.h"
+#include "../include/laminate_solver.h"
+
+using std::cout; using std::endl;
+
+// Number of calls of the global operator new since the program started.
+std::size_t allocation_count = 0;
+
+void* operator new(std::size_t size) {
+    allocation_count++;
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+// Print the check if it failed, and count the failures.
+int failures = 0;
+void check(bool passed, const std::string& what);
+
+int main() {
+    Properties p;
+    p.E1 = 1.38e11;
+    p.E2 = 1.0e10;
+    p.nu12 = 0.34;
+    p.G12 = 7.0e9;
+    p.G13 = 7.0e9;
+    p.G23 = 3.7e9;
+    p.alpha1 = -0.3e-6;
+    p.alpha2 = 28.1e-6;
+    p.beta1 = 0.;
+    p.beta2 = 0.44;
+    std::vector<ply> plies;
+    const double angles[] = {0., 45., -45., 90., 90., -45., 45., 0.};
+    for (double theta : angles) {
+        plies.push_back(ply("M1", p, theta, 1.5e-4));
+    }
+    Eigen::Matrix<double, 6, 1> load;
+    load << 7e6, -2e5, 1e5, 10., -5., 2.;
+
+    laminate_solver solver(2 * plies.size());
+    solver.set_plies(plies);
+
+    // The edit/solve loop of a finite element model: nothing may allocate.
+    std::size_t before = allocation_count;
+    for (int step = 0; step < 1000; step++) {
+        std::size_t i = step % plies.size();
+        solver.set_ply_angle(i, angles[i] + (step % 7) * 5.);
+        solver.set_ply_thickness(i, 1.5e-4 * (1 + (step % 3) * 0.1));
+        solver.solve(load, -100., 0.01);
+    }
+    std::size_t allocations = allocation_count - before;
+    check(allocations == 0, "no allocation in the edit/solve loop ("
+          + std::to_string(allocations) + " allocations)");
+
+    // Thicknesses a laminate would reject leave the ply unchanged.
+    double thickness = solver.thickness_[0];
+    check(!solver.set_ply_thickness(0, 0.) 
+          && !solver.set_ply_thickness(0, -1e-4)
+          && !solver.set_ply_thickness(0, std::nan(""))
+          && !solver.set_ply_thickness(0, HUGE_VAL)
+          && solver.thickness_[0] == thickness, "invalid thicknesses");
+
+    // The last state of the solver against a laminate built from scratch.
+    for (std::size_t i = 0; i < plies.size(); i++) {
+        plies[i] = ply("M1", p, solver.theta_[i], solver.thickness_[i]);
+    }
+    laminate lam(plies, load, -100., 0.01);
+    check((solver.A_ - lam.A_).norm() <= 1e-12 * lam.A_.norm(), "A");
+    check((solver.D_ - lam.D_).norm() <= 1e-12 * lam.D_.norm(), "D");
+    check((solver.mid_strain_ - lam.mid_strain_).norm()
+          <= 1e-10 * lam.mid_strain_.norm(), "mid-plane strain");
+    check((solver.mid_curvature_ - lam.mid_curvature_).norm()
+          <= 1e-10 * lam.mid_curvature_.norm(), "mid-plane curvature");
+
+    if (failures == 0) {
+        cout << "laminate_solver_test: all checks passed." << endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+void check(bool passed, const std::string& what) {
+    if (!passed) {
+        cout << "laminate_solver_test: FAILED " << what << endl;
+        failures++;
+    }
+}
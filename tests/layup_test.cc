@@ -0,0 +1,117 @@
+//! Checks that the closed-form stiffness of a compressed layup matches the 
+//! ABD accumulated over its expanded plies, and that the laminate built from
+//! a layup has the response of the laminate built from the expanded plies.
+
+#include <Eigen/Dense>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../include/ply.h"
+#include "../include/layup.h"
+#include "../include/laminate.h"
+#include "../include/input_parser.h"
+
+using std::cout; using std::endl;
+using std::string; using std::vector;
+
+// Material data file of the repository; make test runs from its root.
+const char* const kMaterialData = "input_files/material_data.lmc";
+
+// Print the check if it failed, and count the failures.
+int failures = 0;
+void check(bool passed, const std::string& what);
+
+// True if a and b agree to tolerance relative to scale.
+template <typename Matrix>
+bool close(const Matrix& a, const Matrix& b, double scale, 
+           double tolerance = 1e-12);
+
+// Compare the layup of the code with its expanded plies.
+void check_code(const string& code, const string& labels, 
+                const string& thicknesses);
+
+int main() {
+    check_code("[0/45/-45/90]8s4", "[M1, M2, M1, M2]", 
+               "[2e-4, 1.5e-4, 2e-4, 1.5e-4]");
+    check_code("[15/-40/70]5", "[M1, M2, M1]", "[2e-4, 1.5e-4, 1e-4]");
+    check_code("[30/-30]2s", "[M1, M2]", "[2e-4, 1.5e-4]");
+    check_code("[0/45]s3", "[M2, M1]", "[1e-4, 3e-4]");
+    check_code("[0/90]", "[M1, M2]", "[2e-4, 1.5e-4]");
+    check_code("[(0/90)2/+-45]s", "[M1, M2, M1]", "[2e-4]");
+
+    // Invalid input gives a layup without plies instead of reading past the
+    // end of the labels or thicknesses.
+    vector<string> input = {"[0/45/90]s", "[M1, M2]", "[1e-4, 1e-4, 1e-4]", 
+                            "[1, 0, 0, 0, 0, 0]"};
+    check(get_layup(input, kMaterialData).base_plies_.empty(), 
+          "a missing material label is rejected");
+    input = {"[0/45]s", "[M1, M9]", "[1e-4, 1e-4]", "[1, 0, 0, 0, 0, 0]"};
+    check(get_layup(input, kMaterialData).base_plies_.empty(), 
+          "an unknown material label is rejected");
+    input = {"[0/45]s", "[M1, M2]", "[1e-4, -1e-4]", "[1, 0, 0, 0, 0, 0]"};
+    check(get_layup(input, kMaterialData).base_plies_.empty(), 
+          "a negative thickness is rejected");
+
+    if (failures == 0) {
+        cout << "layup_test: all checks passed." << endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+void check_code(const string& code, const string& labels, 
+                const string& thicknesses) {
+    vector<string> input = {code, labels, thicknesses, 
+                            "[7e6, -2e5, 1e5, 10, -5, 2]"};
+    layup plies = get_layup(input, kMaterialData);
+    vector<ply> expanded = get_ply_vector(input, kMaterialData);
+    check(plies.ply_count() == expanded.size(), code + ": ply count");
+    if (plies.ply_count() != expanded.size()) {
+        return;
+    }
+    for (std::size_t i = 0; i < expanded.size(); i++) {
+        if (plies.ply_at(i).theta_ != expanded[i].theta_
+            || plies.ply_at(i).thickness_ != expanded[i].thickness_) {
+            check(false, code + ": ply " + std::to_string(i));
+            return;
+        }
+    }
+
+    BlockStiffness composed = plies.stiffness();
+    BlockStiffness summed = ply_block_stiffness(expanded);
+    double h = summed.height;
+    double a = summed.A.norm();
+    double s = summed.S0.norm();
+    check(std::abs(composed.height - h) <= 1e-12 * h, code + ": height");
+    check(close(composed.A, summed.A, a), code + ": A");
+    check(close(composed.B, summed.B, a * h), code + ": B");
+    check(close(composed.D, summed.D, a * h * h), code + ": D");
+    check(close(composed.S0, summed.S0, s), code + ": S0");
+    check(close(composed.S2, summed.S2, s * h * h), code + ": S2");
+    check(close(composed.NT, summed.NT, summed.NT.norm()), code + ": NT");
+    check(close(composed.MT, summed.MT, summed.NT.norm() * h), code + ": MT");
+
+    Eigen::Matrix<double, 6, 1> load;
+    load << 7e6, -2e5, 1e5, 10., -5., 2.;
+    laminate from_layup(plies, load, -100., 0.01);
+    laminate from_plies(expanded, load, -100., 0.01);
+    Eigen::Matrix<double, 6, 1> response_layup;
+    Eigen::Matrix<double, 6, 1> response_plies;
+    response_layup << from_layup.mid_strain_, from_layup.mid_curvature_ * h;
+    response_plies << from_plies.mid_strain_, from_plies.mid_curvature_ * h;
+    check(close(response_layup, response_plies, response_plies.norm(), 1e-9),
+          code + ": laminate response");
+    check(from_layup.ply_vector_.size() == expanded.size(), 
+          code + ": laminate plies");
+}
+
+void check(bool passed, const std::string& what) {
+    if (!passed) {
+        cout << "layup_test: FAILED " << what << endl;
+        failures++;
+    }
+}
+
+template <typename Matrix>
+bool close(const Matrix& a, const Matrix& b, double scale, double tolerance) {
+    return (a - b).norm() <= tolerance * scale;
+}
@@ -0,0 +1,136 @@
+//! Checks of the compiled material database: lookups of the first, last and
+//! missing labels, the label size limit, and the rejection of truncated
+//! files and files with a bad magic number.
+
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include "../include/ply.h"
+#include "../include/material_db.h"
+#include "../include/input_parser.h"
+
+using std::cout; using std::endl;
+using std::string; using std::vector; using std::map;
+
+// Scratch files of the test, removed at the end.
+const char* const kTextFile = "material_db_test.lmc";
+const char* const kDatabaseFile = "material_db_test.db";
+const char* const kDamagedFile = "material_db_test_damaged.db";
+
+// Print the check if it failed, and count the failures.
+int failures = 0;
+void check(bool passed, const std::string& what);
+
+// Write the text of a material_data file.
+void write_file(const string& filename, const string& text);
+
+// The bytes of a file.
+string read_file(const string& filename);
+
+// True if every property of p and q is equal.
+bool same(const Properties& p, const Properties& q);
+
+int main() {
+    // The labels are out of order in the text file; the database sorts them.
+    write_file(kTextFile,
+        "Label E1      E2      nu12 G12    G13    G23    alpha1 alpha2\n"
+        "M5    1.00e11 2.00e10 0.25 1.2e10 1.2e10 7.5e9  6.3e-6 20.0e-6\n"
+        "A1    1.38e11 1.00e10 0.34 7.0e9  7.0e9  3.7e9  -3e-7  28.1e-6\n"
+        "Z9    4.50e10 1.20e10 0.28 5.5e9  5.5e9  4.0e9  7e-6   2.2e-5\n");
+    check(compile_material_data(kTextFile, kDatabaseFile), "compile");
+    map<string, Properties> text;
+    check(open_material_data(kTextFile, text) == nullptr && text.size() == 3,
+          "a text file is read at once");
+
+    {
+        material_db database(kDatabaseFile);
+        check(database.is_open() && database.count_ == 3, "open");
+        Properties p;
+        check(database.find("A1", p) && same(p, text["A1"]), "first label");
+        check(database.find("Z9", p) && same(p, text["Z9"]), "last label");
+        check(database.find("M5", p) && same(p, text["M5"]), "middle label");
+        check(!database.find("B0", p) && !database.find("", p)
+              && !database.find("Z99", p), "missing labels");
+        check(!database.find(string(kMaterialLabelSize, 'A'), p),
+              "a label of kMaterialLabelSize bytes is not found");
+        map<string, Properties> all = database.all();
+        check(all.size() == 3 && same(all["M5"], text["M5"]), "all");
+    }
+
+    // open_material_data keeps the database open and reads nothing until
+    // find_materials asks for labels.
+    map<string, Properties> materials;
+    std::unique_ptr<material_db> database =
+        open_material_data(kDatabaseFile, materials);
+    check(database != nullptr && materials.empty(), "open_material_data");
+    if (database != nullptr) {
+        find_materials(*database, {"Z9", "B0", "Z9"}, materials);
+        check(materials.size() == 1 && same(materials["Z9"], text["Z9"]),
+              "find_materials");
+    }
+    database.reset();
+
+    // A label must leave room for the terminating NUL.
+    map<string, Properties> long_label = {
+        {string(kMaterialLabelSize - 1, 'L'), text["A1"]}};
+    check(write_material_db(long_label, kDamagedFile),
+          "a label of kMaterialLabelSize - 1 bytes is written");
+    long_label = {{string(kMaterialLabelSize, 'L'), text["A1"]}};
+    check(!write_material_db(long_label, kDamagedFile),
+          "a label of kMaterialLabelSize bytes is rejected");
+    write_file(kTextFile, "Label E1 E2 nu12 G12\n"
+               + string(kMaterialLabelSize, 'L') + " 1 1 0.3 1\n");
+    check(!compile_material_data(kTextFile, kDamagedFile),
+          "compile rejects a label of kMaterialLabelSize bytes");
+
+    // Damaged files are not opened.
+    string bytes = read_file(kDatabaseFile);
+    write_file(kDamagedFile, bytes.substr(0, bytes.size() - 1));
+    check(!material_db(kDamagedFile).is_open(), "a truncated record");
+    write_file(kDamagedFile, bytes.substr(0, 12));
+    check(!material_db(kDamagedFile).is_open(), "a truncated header");
+    string bad_magic = bytes;
+    bad_magic[0] = 'X';
+    write_file(kDamagedFile, bad_magic);
+    check(!is_material_db(kDamagedFile)
+          && !material_db(kDamagedFile).is_open(), "a bad magic number");
+    check(!material_db("material_db_test_missing.db").is_open(),
+          "a missing file");
+
+    std::remove(kTextFile);
+    std::remove(kDatabaseFile);
+    std::remove(kDamagedFile);
+    if (failures == 0) {
+        cout << "material_db_test: all checks passed." << endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+void check(bool passed, const std::string& what) {
+    if (!passed) {
+        cout << "material_db_test: FAILED " << what << endl;
+        failures++;
+    }
+}
+
+void write_file(const string& filename, const string& text) {
+    std::ofstream file(filename, std::ios::binary);
+    file << text;
+}
+
+string read_file(const string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    return string(std::istreambuf_iterator<char>(file),
+                  std::istreambuf_iterator<char>());
+}
+
+bool same(const Properties& p, const Properties& q) {
+    return p.E1 == q.E1 && p.E2 == q.E2 && p.nu12 == q.nu12 && p.G12 == q.G12
+        && p.G13 == q.G13 && p.G23 == q.G23 && p.alpha1 == q.alpha1
+        && p.alpha2 == q.alpha2 && p.beta1 == q.beta1 && p.beta2 == q.beta2;
+}
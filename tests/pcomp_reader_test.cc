@@ -0,0 +1,219 @@
+//! Checks of the Nastran PCOMP reader: fixed and free fields, continuations,
+//! short exponents, LAM = SYM, the Z0 offset, duplicate cards and the cards
+//! after ENDDATA.
+
+#include <Eigen/Dense>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include "../include/ply.h"
+#include "../include/layup.h"
+#include "../include/pcomp_reader.h"
+
+using std::cout; using std::endl;
+using std::string; using std::vector;
+
+// Scratch file of the test, removed at the end.
+const char* const kDeckFile = "pcomp_reader_test.bdf";
+
+// The same [0/45/-45/90]s layup of M1 (MID 1) and M2 (MID 2) of
+// material_data.lmc, written out in fixed fields (PCOMP 10) and as LAM = SYM
+// in free fields (PCOMP 11, and PCOMP 12 with a Z0 offset).
+const char* const kDeck =
+    "SOL 101\n"
+    "CEND\n"
+    "PCOMP   98      this card is before BEGIN BULK\n"
+    "BEGIN BULK\n"
+    "$ MAT8 1 with short exponents and a fixed-field continuation\n"
+    "MAT8    1       1.38+11 1.00+10 .34     7.00+9  7.00+9  3.70+9  "
+        "1500.   +M1\n"
+    "+M1     -.3-6   28.1-6\n"
+    "$ MAT8 2 in free fields, with a D exponent\n"
+    "MAT8,2,1.0E11,2.0e10,0.25,1.2D10,1.2+10,7.5+9\n"
+    ",6.3-6,20.0e-6\n"
+    "PCOMP   10                                                      "
+        "        +P1\n"
+    "+P1     1       2.-4    0.      YES     2       1.5-4   45.     "
+        "YES     +P2\n"
+    "+P2     1       2.-4    -45.            2       1.5-4   90.     "
+        "        +P3\n"
+    "+P3     2       1.5-4   90.             1       2.-4    -45.\n"
+    "        2       1.5-4   45.             1       2.-4    0.\n"
+    "PCOMP,11,,,,,,,SYM\n"
+    ",1,2.-4,0.,,2,1.5-4,45.\n"
+    ",1,2.-4,-45.,,2,1.5-4,90.\n"
+    "PCOMP,12,-1.0e-3,,,,,,SYM\n"
+    ",1,2.-4,0.,,2,1.5-4,45.\n"
+    ",1,2.-4,-45.,,2,1.5-4,90.\n"
+    "$ Blank MID and T repeat the ply below, a blank THETA is 0\n"
+    "PCOMP,15\n"
+    ",2,3.-4,30.,,,,-30.\n"
+    ",,1.-4\n"
+    "$ Duplicates of MAT8 1 and PCOMP 10, skipped\n"
+    "MAT8,1,5.0e10,5.0e10,0.3,1.0e9\n"
+    "PCOMP,10,,,,,,,SYM\n"
+    ",2,1.-3,0.\n"
+    "$ An unsupported LAM option and an unknown material\n"
+    "pcomp   13                                                      MEM\n"
+    "        1       1.-4\n"
+    "PCOMP   14\n"
+    "        7       1.-4\n"
+    "ENDDATA\n"
+    "PCOMP,99\n"
+    ",1,1.-4,0.\n";
+
+// Print the check if it failed, and count the failures.
+int failures = 0;
+void check(bool passed, const std::string& what);
+
+// True if a and b agree to 1e-12 relative to scale.
+bool close(const Eigen::Matrix3d& a, const Eigen::Matrix3d& b, double scale);
+
+// The result of the PID in results, or nullptr.
+const PcompResult* find_result(const vector<PcompResult>& results, int pid);
+
+// M1 and M2 of material_data.lmc.
+Properties material_1();
+Properties material_2();
+
+int main() {
+    {
+        std::ofstream deck_file(kDeckFile);
+        deck_file << kDeck;
+    }
+    NastranDeck deck;
+    check(read_nastran_deck(kDeckFile, deck), "read");
+    check(!read_nastran_deck("pcomp_reader_test_missing.bdf", deck),
+          "a missing deck");
+
+    // Only the first MAT8 1 is kept, and the short exponents are read.
+    check(deck.materials_.size() == 2, "two materials");
+    const Properties& m1 = deck.materials_[1];
+    const Properties& m2 = deck.materials_[2];
+    check(m1.E1 == 1.38e11 && m1.E2 == 1e10 && m1.nu12 == .34
+          && m1.G12 == 7e9 && m1.G13 == 7e9 && m1.G23 == 3.7e9
+          && m1.alpha1 == -.3e-6 && m1.alpha2 == 28.1e-6,
+          "fixed-field MAT8 with short exponents");
+    check(m2.E1 == 1e11 && m2.E2 == 2e10 && m2.nu12 == 0.25
+          && m2.G12 == 1.2e10 && m2.G13 == 1.2e10 && m2.G23 == 7.5e9
+          && m2.alpha1 == 6.3e-6 && m2.alpha2 == 20e-6,
+          "free-field MAT8 with a D exponent");
+
+    // Cards before BEGIN BULK, after ENDDATA and the duplicate PCOMP 10 are
+    // not in the deck.
+    vector<int> pids;
+    for (const PcompCard& card : deck.pcomps_) {
+        pids.push_back(card.pid);
+    }
+    check(pids == vector<int>({10, 11, 12, 15, 13, 14}), "PCOMP cards");
+    check(deck.pcomps_[0].plies.size() == 8 && !deck.pcomps_[0].symmetric,
+          "fixed-field PCOMP with continuations");
+    check(deck.pcomps_[1].plies.size() == 4 && deck.pcomps_[1].symmetric,
+          "free-field PCOMP with LAM = SYM");
+    const vector<PcompPly>& repeated = deck.pcomps_[3].plies;
+    check(repeated.size() == 3 && repeated[1].mid == 2
+          && repeated[1].thickness == 3e-4 && repeated[1].theta == -30.,
+          "blank MID and T repeat the ply below");
+    check(repeated.size() == 3 && repeated[2].mid == 2
+          && repeated[2].thickness == 1e-4 && repeated[2].theta == 0.,
+          "a blank THETA is 0");
+
+    vector<PcompResult> results = evaluate_pcomps(deck, 2);
+    const PcompResult* full = find_result(results, 10);
+    const PcompResult* symmetric = find_result(results, 11);
+    const PcompResult* offset = find_result(results, 12);
+    if (full == nullptr || symmetric == nullptr || offset == nullptr) {
+        check(false, "results of PCOMP 10, 11 and 12");
+        return 1;
+    }
+
+    // The full card against the plies of material_data.lmc.
+    vector<BasicLamina<double>> plies = {
+        {material_1(), 0, 2e-4}, {material_2(), 45, 1.5e-4},
+        {material_1(), -45, 2e-4}, {material_2(), 90, 1.5e-4},
+        {material_2(), 90, 1.5e-4}, {material_1(), -45, 2e-4},
+        {material_2(), 45, 1.5e-4}, {material_1(), 0, 2e-4}};
+    BlockStiffness expected = assemble_abd(plies);
+    double scale = expected.A.norm();
+    double h = expected.height;
+    check(full->valid && close(full->stiffness.A, expected.A, scale)
+          && close(full->stiffness.B, expected.B, scale * h)
+          && close(full->stiffness.D, expected.D, scale * h * h),
+          "PCOMP 10 ABD");
+
+    // LAM = SYM mirrors the listed plies.
+    check(symmetric->valid 
+          && symmetric->stiffness.height == full->stiffness.height
+          && close(symmetric->stiffness.A, full->stiffness.A, scale)
+          && close(symmetric->stiffness.B, full->stiffness.B, scale * h)
+          && close(symmetric->stiffness.D, full->stiffness.D, scale * h * h),
+          "LAM = SYM");
+
+    // Z0 = -1e-3 puts the mid-plane at -1e-3 + h/2 above the reference plane.
+    BlockStiffness shifted = shift_block(expected, -1e-3 + h / 2);
+    check(offset->valid && close(offset->stiffness.A, shifted.A, scale)
+          && close(offset->stiffness.B, shifted.B, scale * h)
+          && close(offset->stiffness.D, shifted.D, scale * h * h)
+          && !offset->stiffness.B.isZero(), "Z0 offset");
+
+    check(!find_result(results, 13)->valid, "unsupported LAM option");
+    check(!find_result(results, 14)->valid, "unknown MAT8");
+
+    std::remove(kDeckFile);
+    if (failures == 0) {
+        cout << "pcomp_reader_test: all checks passed." << endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+void check(bool passed, const std::string& what) {
+    if (!passed) {
+        cout << "pcomp_reader_test: FAILED " << what << endl;
+        failures++;
+    }
+}
+
+bool close(const Eigen::Matrix3d& a, const Eigen::Matrix3d& b, double scale) {
+    return (a - b).cwiseAbs().maxCoeff() <= 1e-12 * scale;
+}
+
+const PcompResult* find_result(const vector<PcompResult>& results, int pid) {
+    for (const PcompResult& result : results) {
+        if (result.pid == pid) {
+            return &result;
+        }
+    }
+    return nullptr;
+}
+
+Properties material_1() {
+    Properties p;
+    p.E1 = 1.38e11;
+    p.E2 = 1.0e10;
+    p.nu12 = 0.34;
+    p.G12 = 7.0e9;
+    p.G13 = 7.0e9;
+    p.G23 = 3.7e9;
+    p.alpha1 = -0.3e-6;
+    p.alpha2 = 28.1e-6;
+    p.beta1 = 0;
+    p.beta2 = 0;
+    return p;
+}
+
+Properties material_2() {
+    Properties p;
+    p.E1 = 1.0e11;
+    p.E2 = 2.0e10;
+    p.nu12 = 0.25;
+    p.G12 = 1.2e10;
+    p.G13 = 1.2e10;
+    p.G23 = 7.5e9;
+    p.alpha1 = 6.3e-6;
+    p.alpha2 = 20.0e-6;
+    p.beta1 = 0;
+    p.beta2 = 0;
+    return p;
+}
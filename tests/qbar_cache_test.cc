@@ -0,0 +1,116 @@
+//! Checks of the Qbar cache: the hit and miss counters, the handling of -0
+//! and non-finite angles, and the bounds of the cache and the material table.
+
+#include <Eigen/Dense>
+#include <iostream>
+#include <string>
+#include <limits>
+#include <cmath>
+#include "../include/ply.h"
+#include "../include/qbar_cache.h"
+
+using std::cout; using std::endl;
+
+// Print the check if it failed, and count the failures.
+int failures = 0;
+void check(bool passed, const std::string& what);
+
+// Unidirectional carbon/epoxy.
+Properties test_material();
+
+int main() {
+    Properties p = test_material();
+    Invariants u = build_invariants(p);
+    clear_qbar_cache();
+
+    // The first lookup of a pair misses, the next ones hit, and both return
+    // the directly built stiffness.
+    CachedStiffness first = cached_stiffness("T300", p, 30.);
+    CachedStiffness second = cached_stiffness("T300", p, 30.);
+    QbarCacheStats stats = qbar_cache_stats();
+    check(stats.hits == 1 && stats.misses == 1 && stats.materials == 1,
+          "one miss, then one hit");
+    check(first.Qbar == build_Qbar(u, 30.) && second.Qbar == first.Qbar
+          && first.Qs == build_Qs(p, 30.), "cached Qbar and Qs");
+
+    // The same label with other properties is another material.
+    Properties q = p;
+    q.E2 *= 2;
+    CachedStiffness other = cached_stiffness("T300", q, 30.);
+    stats = qbar_cache_stats();
+    check(stats.misses == 2 && stats.materials == 2,
+          "changed properties miss");
+    check(other.Qbar == build_Qbar(build_invariants(q), 30.),
+          "changed properties Qbar");
+
+    // -0 and +0 share one entry.
+    cached_stiffness("T300", p, 0.);
+    cached_stiffness("T300", p, -0.);
+    stats = qbar_cache_stats();
+    check(stats.hits == 2 && stats.misses == 3, "-0 hits the entry of +0");
+
+    // Non-finite angles are built every time and never counted.
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const double inf = std::numeric_limits<double>::infinity();
+    CachedStiffness not_a_number = cached_stiffness("T300", p, nan);
+    cached_stiffness("T300", p, nan);
+    cached_stiffness("T300", p, inf);
+    stats = qbar_cache_stats();
+    check(stats.hits == 2 && stats.misses == 3, "NaN and inf are not cached");
+    check(std::isnan(not_a_number.Qbar(0, 0)), "NaN angle Qbar");
+
+    // A sweep over more angles than the capacity keeps working.
+    clear_qbar_cache();
+    for (std::size_t i = 0; i <= kQbarCacheCapacity; i++) {
+        cached_stiffness("T300", p, 1e-3 * i + 1);
+    }
+    cached_stiffness("T300", p, 1e-3 * kQbarCacheCapacity + 1);
+    stats = qbar_cache_stats();
+    check(stats.hits == 1 && stats.misses == kQbarCacheCapacity + 1,
+          "the last entry survives the reset");
+
+    // More materials than the table holds empty it, cache included.
+    clear_qbar_cache();
+    for (std::size_t i = 0; i < kQbarCacheMaterials; i++) {
+        Properties m = p;
+        m.E1 += i;
+        cached_stiffness("sweep", m, 45.);
+    }
+    check(qbar_cache_stats().materials == kQbarCacheMaterials, "full table");
+    CachedStiffness after_reset = cached_stiffness("T300", p, 30.);
+    stats = qbar_cache_stats();
+    check(stats.materials == 1, "the table was emptied when full");
+    check(after_reset.Qbar == build_Qbar(u, 30.), "Qbar after the reset");
+
+    clear_qbar_cache();
+    stats = qbar_cache_stats();
+    check(stats.hits == 0 && stats.misses == 0 && stats.materials == 0,
+          "clear_qbar_cache");
+
+    if (failures == 0) {
+        cout << "qbar_cache_test: all checks passed." << endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+void check(bool passed, const std::string& what) {
+    if (!passed) {
+        cout << "qbar_cache_test: FAILED " << what << endl;
+        failures++;
+    }
+}
+
+Properties test_material() {
+    Properties p;
+    p.E1 = 1.38e11;
+    p.E2 = 1.0e10;
+    p.nu12 = 0.34;
+    p.G12 = 7.0e9;
+    p.G13 = 7.0e9;
+    p.G23 = 3.7e9;
+    p.alpha1 = -0.3e-6;
+    p.alpha2 = 28.1e-6;
+    p.beta1 = 0;
+    p.beta2 = 0.44;
+    return p;
+}